@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_session.h"
 #include "history/history.h"
 #include "history/history_item.h"
+#include "history/history_search_index.h"
 #include "main/main_session.h"
 
 namespace Api {
@@ -72,9 +73,15 @@ MessagesSearch::~MessagesSearch() {
 		base::take(_searchInHistoryRequest));
 }
 
+void MessagesSearch::enableLocalSearch() {
+	_localSearch = true;
+}
+
 void MessagesSearch::searchMessages(Request request) {
 	_request = std::move(request);
 	_offsetId = {};
+	_localFound.clear();
+	_localFoundToken = QString();
 	searchRequest();
 }
 
@@ -94,6 +101,7 @@ void MessagesSearch::searchRequest() {
 			searchReceived(it->second, _requestId, nextToken);
 			return;
 		}
+		searchLocal(nextToken);
 	}
 	auto callback = [=](Fn<void()> finish) {
 		using Flag = MTPmessages_Search::Flag;
@@ -146,6 +154,61 @@ void MessagesSearch::searchRequest() {
 		std::move(callback));
 }
 
+void MessagesSearch::searchLocal(const QString &nextToken) {
+	_localFound.clear();
+	_localFoundToken = nextToken;
+	if (!_localSearch
+		|| _request.query.isEmpty()
+		|| !_request.tags.empty()
+		|| (_request.from && _history->peer->isSelf())) {
+		return;
+	}
+	const auto ids = _history->searchIndex()->search({
+		.text = _request.query,
+		.from = _request.from,
+		.topMsgId = _request.topMsgId,
+	});
+	if (ids.empty()) {
+		return;
+	}
+	const auto peerId = _history->peer->id;
+	_localFound.reserve(ids.size());
+	for (const auto id : ids) {
+		_localFound.push_back(FullMsgId(peerId, id));
+	}
+
+	// Total is unknown until the server answers, a different token
+	// makes the server results replace the local ones.
+	_messagesFounds.fire({
+		-1,
+		_localFound,
+		nextToken + u"\n#local"_q,
+	});
+}
+
+void MessagesSearch::mergeLocalFound(FoundMessages &found) {
+	const auto local = base::take(_localFound);
+	if (base::take(_localFoundToken) != found.nextToken
+		|| found.messages.empty()) {
+		return;
+	}
+
+	// Messages newer than the oldest one in the first page should have
+	// been found by the server, unless its index didn't catch up yet.
+	const auto oldest = found.messages.back().msg;
+	auto added = 0;
+	for (const auto &id : local) {
+		if (id.msg > oldest && !ranges::contains(found.messages, id)) {
+			found.messages.push_back(id);
+			++added;
+		}
+	}
+	if (added) {
+		ranges::sort(found.messages, ranges::greater(), &FullMsgId::msg);
+		found.total += added;
+	}
+}
+
 void MessagesSearch::searchReceived(
 		const TLMessages &result,
 		mtpRequestId requestId,
@@ -198,6 +261,7 @@ void MessagesSearch::searchReceived(
 	});
 	if (!_offsetId) {
 		_cacheOfStartByToken.emplace(nextToken, result);
+		mergeLocalFound(found);
 	}
 	_requestId = 0;
 	_offsetId = found.messages.empty()
@@ -45,6 +45,10 @@ public:
 	explicit MessagesSearch(not_null<History*> history);
 	~MessagesSearch();
 
+	// Show results from messages already loaded in History::blocks
+	// before the server answers, then merge the server ones in.
+	void enableLocalSearch();
+
 	void searchMessages(Request request);
 	void searchMore();
 
@@ -53,6 +57,8 @@ public:
 private:
 	using TLMessages = MTPmessages_Messages;
 	void searchRequest();
+	void searchLocal(const QString &nextToken);
+	void mergeLocalFound(FoundMessages &found);
 	void searchReceived(
 		const TLMessages &result,
 		mtpRequestId requestId,
@@ -68,6 +74,10 @@ private:
 	int _searchInHistoryRequest = 0; // Not real mtpRequestId.
 	mtpRequestId _requestId = 0;
 
+	MessageIdsList _localFound;
+	QString _localFoundToken;
+	bool _localSearch = false;
+
 	rpl::event_stream<FoundMessages> _messagesFounds;
 
 };
@@ -13,6 +13,7 @@ namespace Api {
 
 MessagesSearchMerged::MessagesSearchMerged(not_null<History*> history)
 : _apiSearch(history) {
+	_apiSearch.enableLocalSearch();
 	if (const auto migrated = history->migrateFrom()) {
 		_migratedSearch.emplace(migrated);
 	}
@@ -59,7 +59,7 @@ void UnreadThings::mediaAndMentionsRead(
 			if (item && item->mentionsMe()) {
 				item->markMediaAndMentionRead();
 			}
-		});
+		}, ApiWrap::MessageDataPriority::Background);
 	}
 }
 
@@ -52,6 +52,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item_helpers.h"
 #include "history/history_unread_things.h"
 #include "core/application.h"
+#include "core/startup_trace.h"
 #include "storage/storage_account.h"
 #include "storage/storage_facade.h"
 #include "storage/storage_user_photos.h"
@@ -478,6 +479,7 @@ void Updates::stateDone(const MTPupdates_State &state) {
 }
 
 void Updates::differenceDone(const MTPupdates_Difference &result) {
+	Core::StartupTrace::MarkFirst("Updates::differenceDone");
 	_failDifferenceTimeout = 1;
 
 	switch (result.type()) {
@@ -695,6 +697,7 @@ void Updates::getDifference() {
 
 	_ptsWaiter.setRequesting(true);
 
+	Core::StartupTrace::MarkFirst("Updates::getDifference");
 	api().request(MTPupdates_GetDifference(
 		MTP_flags(0),
 		MTP_int(_ptsWaiter.current()),
@@ -1565,7 +1568,8 @@ void Updates::applyUpdates(
 					session().api().requestMessageData(
 						item->history()->peer,
 						item->id,
-						nullptr);
+						nullptr,
+						ApiWrap::MessageDataPriority::Background);
 				}
 				item->applySentMessage(sent.text, d, wasAlready);
 			}
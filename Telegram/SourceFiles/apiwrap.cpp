@@ -94,6 +94,13 @@ constexpr auto kSaveCloudDraftTimeout = 1000;
 constexpr auto kTopPromotionInterval = TimeId(60 * 60);
 constexpr auto kTopPromotionMinDelay = TimeId(10);
 constexpr auto kSmallDelayMs = 5;
+
+// Message data lookups in the background wait for more ids, but not
+// longer than the max delay. Visible items are requested right away.
+constexpr auto kMessageDataCoalesceDelay = crl::time(5);
+constexpr auto kMessageDataMaxDelay = crl::time(30);
+constexpr auto kMessageDataPerRequest = 100;
+constexpr auto kMessageDataMetricsWindow = 5 * crl::time(1000);
 constexpr auto kReadFeaturedSetsTimeout = crl::time(1000);
 constexpr auto kFileLoaderQueueStopTimeout = crl::time(5000);
 constexpr auto kStickersByEmojiInvalidateTimeout = crl::time(6 * 1000);
@@ -157,7 +164,8 @@ void ShowChannelsLimitBox(not_null<PeerData*> peer) {
 ApiWrap::ApiWrap(not_null<Main::Session*> session)
 : MTP::Sender(&session->account().mtp())
 , _session(session)
-, _messageDataResolveDelayed([=] { resolveMessageDatas(); })
+, _messageDataResolveTimer([=] { resolveMessageDatas(); })
+, _messageDataMetricsTimer([=] { logMessageDataMetrics(); })
 , _webPagesTimer([=] { resolveWebPages(); })
 , _draftsSaveTimer([=] { saveDraftsToCloud(); })
 , _featuredSetsReadTimer([=] { readFeaturedSets(); })
@@ -608,27 +616,69 @@ void ApiWrap::sendMessageFail(
 void ApiWrap::requestMessageData(
 		PeerData *peer,
 		MsgId msgId,
-		Fn<void()> done) {
+		Fn<void()> done,
+		MessageDataPriority priority) {
 	auto &requests = (peer && peer->isChannel())
 		? _channelMessageDataRequests[peer->asChannel()][msgId]
 		: _messageDataRequests[msgId];
 	if (done) {
 		requests.callbacks.push_back(std::move(done));
 	}
-	if (!requests.requestId) {
-		_messageDataResolveDelayed.call();
+	if (requests.requestId) {
+		return;
+	} else if (priority == MessageDataPriority::Visible) {
+		requests.visible = true;
+		_messageDataResolveDeadline = crl::now();
+	}
+	scheduleMessageDataResolve();
+}
+
+void ApiWrap::scheduleMessageDataResolve() {
+	const auto now = crl::now();
+	if (!_messageDataResolveDeadline) {
+		_messageDataResolveDeadline = now + kMessageDataMaxDelay;
 	}
+	_messageDataResolveTimer.callOnce(std::clamp(
+		_messageDataResolveDeadline - now,
+		crl::time(0),
+		kMessageDataCoalesceDelay));
+}
+
+void ApiWrap::messageDataChatOpened(not_null<PeerData*> peer) {
+	logMessageDataMetrics();
+	_messageDataMetrics = { .peer = peer };
+	_messageDataMetricsTimer.callOnce(kMessageDataMetricsWindow);
 }
 
-QVector<MTPInputMessage> ApiWrap::collectMessageIds(
+void ApiWrap::logMessageDataMetrics() {
+	const auto metrics = std::exchange(
+		_messageDataMetrics,
+		MessageDataMetrics());
+	_messageDataMetricsTimer.cancel();
+	if (!metrics.peer) {
+		return;
+	}
+	DEBUG_LOG(("API Info: opening chat %1 requested %2 messages data "
+		"(%3 visible) in %4 requests."
+		).arg(metrics.peer->id.value
+		).arg(metrics.ids
+		).arg(metrics.visible
+		).arg(metrics.requests));
+}
+
+std::vector<MsgId> ApiWrap::collectMessageIds(
 		const MessageDataRequests &requests) {
-	auto result = QVector<MTPInputMessage>();
+	auto result = std::vector<MsgId>();
 	result.reserve(requests.size());
 	for (const auto &[msgId, request] : requests) {
-		if (request.requestId > 0) {
-			continue;
+		if (!request.requestId && request.visible) {
+			result.push_back(msgId);
+		}
+	}
+	for (const auto &[msgId, request] : requests) {
+		if (!request.requestId && !request.visible) {
+			result.push_back(msgId);
 		}
-		result.push_back(MTP_inputMessageID(MTP_int(msgId)));
 	}
 	return result;
 }
@@ -651,58 +701,70 @@ auto ApiWrap::messageDataRequests(ChannelData *channel, bool onlyExisting)
 }
 
 void ApiWrap::resolveMessageDatas() {
+	_messageDataResolveTimer.cancel();
+	_messageDataResolveDeadline = 0;
 	if (_messageDataRequests.empty() && _channelMessageDataRequests.empty()) {
 		return;
 	}
 
-	const auto ids = collectMessageIds(_messageDataRequests);
-	if (!ids.isEmpty()) {
-		const auto requestId = request(MTPmessages_GetMessages(
-			MTP_vector<MTPInputMessage>(ids)
-		)).done([=](
-				const MTPmessages_Messages &result,
-				mtpRequestId requestId) {
-			_session->data().processExistingMessages(nullptr, result);
-			finalizeMessageDataRequest(nullptr, requestId);
-		}).fail([=](const MTP::Error &error, mtpRequestId requestId) {
-			finalizeMessageDataRequest(nullptr, requestId);
-		}).afterDelay(kSmallDelayMs).send();
-
-		for (auto &[msgId, request] : _messageDataRequests) {
-			if (request.requestId > 0) {
-				continue;
-			}
-			request.requestId = requestId;
-		}
-	}
+	// Channel messages are requested by channel, all the requests are
+	// sent in one pass, so they're packed together in one container.
+	sendMessageDataRequests(nullptr, _messageDataRequests);
 	for (auto j = _channelMessageDataRequests.begin(); j != _channelMessageDataRequests.cend();) {
 		if (j->second.empty()) {
 			j = _channelMessageDataRequests.erase(j);
 			continue;
 		}
-		const auto ids = collectMessageIds(j->second);
-		if (!ids.isEmpty()) {
-			const auto channel = j->first;
-			const auto requestId = request(MTPchannels_GetMessages(
-				channel->inputChannel,
-				MTP_vector<MTPInputMessage>(ids)
-			)).done([=](
-					const MTPmessages_Messages &result,
-					mtpRequestId requestId) {
-				_session->data().processExistingMessages(channel, result);
-				finalizeMessageDataRequest(channel, requestId);
-			}).fail([=](const MTP::Error &error, mtpRequestId requestId) {
-				finalizeMessageDataRequest(channel, requestId);
-			}).afterDelay(kSmallDelayMs).send();
+		sendMessageDataRequests(j->first, j->second);
+		++j;
+	}
+}
 
-			for (auto &[msgId, request] : j->second) {
-				if (request.requestId > 0) {
-					continue;
-				}
-				request.requestId = requestId;
-			}
+void ApiWrap::sendMessageDataRequests(
+		ChannelData *channel,
+		MessageDataRequests &requests) {
+	const auto ids = collectMessageIds(requests);
+	const auto done = [=](
+			const MTPmessages_Messages &result,
+			mtpRequestId requestId) {
+		_session->data().processExistingMessages(channel, result);
+		finalizeMessageDataRequest(channel, requestId);
+	};
+	const auto fail = [=](const MTP::Error &error, mtpRequestId requestId) {
+		finalizeMessageDataRequest(channel, requestId);
+	};
+	for (auto from = begin(ids); from != end(ids);) {
+		const auto till = from + std::min(
+			int(end(ids) - from),
+			kMessageDataPerRequest);
+		auto list = QVector<MTPInputMessage>();
+		list.reserve(till - from);
+		for (auto i = from; i != till; ++i) {
+			list.push_back(MTP_inputMessageID(MTP_int(*i)));
+		}
+		const auto requestId = channel
+			? request(MTPchannels_GetMessages(
+				channel->inputChannel,
+				MTP_vector<MTPInputMessage>(list)
+			)).done(done).fail(fail).afterDelay(kSmallDelayMs).send()
+			: request(MTPmessages_GetMessages(
+				MTP_vector<MTPInputMessage>(list)
+			)).done(done).fail(fail).afterDelay(kSmallDelayMs).send();
+		auto visible = 0;
+		for (auto i = from; i != till; ++i) {
+			auto &request = requests[*i];
+			request.requestId = requestId;
+			visible += request.visible ? 1 : 0;
 		}
-		++j;
+		DEBUG_LOG(("API Info: requesting %1 messages data (%2 visible)."
+			).arg(list.size()
+			).arg(visible));
+		if (_messageDataMetrics.peer) {
+			++_messageDataMetrics.requests;
+			_messageDataMetrics.ids += list.size();
+			_messageDataMetrics.visible += visible;
+		}
+		from = till;
 	}
 }
 
@@ -162,7 +162,16 @@ public:
 		bool archived,
 		Fn<void()> callback);
 
-	void requestMessageData(PeerData *peer, MsgId msgId, Fn<void()> done);
+	enum class MessageDataPriority {
+		Visible,
+		Background,
+	};
+	void requestMessageData(
+		PeerData *peer,
+		MsgId msgId,
+		Fn<void()> done,
+		MessageDataPriority priority = MessageDataPriority::Visible);
+	void messageDataChatOpened(not_null<PeerData*> peer);
 	QString exportDirectMessageLink(
 		not_null<HistoryItem*> item,
 		bool inRepliesContext,
@@ -429,8 +438,15 @@ private:
 
 		mtpRequestId requestId = 0;
 		Callbacks callbacks;
+		bool visible = false;
 	};
 	using MessageDataRequests = base::flat_map<MsgId, MessageDataRequest>;
+	struct MessageDataMetrics {
+		PeerData *peer = nullptr;
+		int requests = 0;
+		int ids = 0;
+		int visible = 0;
+	};
 	using SharedMediaType = Storage::SharedMediaType;
 
 	struct StickersByEmoji {
@@ -464,12 +480,17 @@ private:
 
 	void saveDraftsToCloud();
 
+	void scheduleMessageDataResolve();
 	void resolveMessageDatas();
+	void sendMessageDataRequests(
+		ChannelData *channel,
+		MessageDataRequests &requests);
 	void finalizeMessageDataRequest(
 		ChannelData *channel,
 		mtpRequestId requestId);
+	void logMessageDataMetrics();
 
-	[[nodiscard]] QVector<MTPInputMessage> collectMessageIds(
+	[[nodiscard]] std::vector<MsgId> collectMessageIds(
 		const MessageDataRequests &requests);
 	[[nodiscard]] MessageDataRequests *messageDataRequests(
 		ChannelData *channel,
@@ -595,7 +616,10 @@ private:
 	base::flat_map<
 		not_null<ChannelData*>,
 		MessageDataRequests> _channelMessageDataRequests;
-	SingleQueuedInvokation _messageDataResolveDelayed;
+	base::Timer _messageDataResolveTimer;
+	crl::time _messageDataResolveDeadline = 0;
+	MessageDataMetrics _messageDataMetrics;
+	base::Timer _messageDataMetricsTimer;
 
 	using PeerRequests = base::flat_map<PeerData*, mtpRequestId>;
 	PeerRequests _fullPeerRequests;
@@ -32,6 +32,8 @@ class VideoTrack;
 
 namespace Calls::Group {
 
+extern const char kOptionGroupCallFrameTimes[];
+
 class MembersRow;
 enum class PanelMode;
 enum class VideoQuality;
@@ -13,19 +13,152 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_peer.h"
 #include "media/view/media_view_pip.h"
 #include "webrtc/webrtc_video_track.h"
+#include "base/options.h"
 #include "ui/image/image_prepare.h"
 #include "ui/painter.h"
+#include "ui/ui_utility.h"
 #include "lang/lang_keys.h"
 #include "styles/style_calls.h"
 #include "styles/palette.h"
 
+#include <QtCore/QMutex>
+
 namespace Calls::Group {
 namespace {
 
 constexpr auto kBlurRadius = 15;
 
+base::options::toggle OptionGroupCallFrameTimes({
+	.id = kOptionGroupCallFrameTimes,
+	.name = "Show video chat frame times.",
+	.description = "Paint frame scaling and painting times over the tiles"
+		" of the video chat when it is rendered without OpenGL.",
+});
+
 } // namespace
 
+const char kOptionGroupCallFrameTimes[] = "group-call-frame-times";
+
+// Scales the frames of one track to the tile size on a background thread.
+// Only the latest frame is kept waiting, older ones are dropped.
+class Viewport::RendererSW::FramePipeline final
+	: public std::enable_shared_from_this<FramePipeline> {
+public:
+	struct Request {
+		QImage original;
+		QRect geometry;
+		QSize size;
+		bool mirror = false;
+	};
+	struct Prepared {
+		QImage image;
+		qint64 key = 0;
+		QSize size;
+		crl::time duration = 0;
+		int dropped = 0;
+		bool mirror = false;
+	};
+
+	explicit FramePipeline(Fn<void(QRect)> ready);
+
+	void request(Request request);
+	void clear();
+	[[nodiscard]] Prepared prepared() const;
+
+private:
+	void process();
+
+	const Fn<void(QRect)> _ready;
+
+	mutable QMutex _mutex;
+	std::optional<Request> _waiting;
+	Prepared _prepared;
+	int _dropped = 0;
+	bool _working = false;
+
+};
+
+Viewport::RendererSW::FramePipeline::FramePipeline(Fn<void(QRect)> ready)
+: _ready(std::move(ready)) {
+}
+
+void Viewport::RendererSW::FramePipeline::request(Request request) {
+	const auto key = request.original.cacheKey();
+	const auto same = [&](qint64 was, QSize size, bool mirror) {
+		return (was == key)
+			&& (size == request.size)
+			&& (mirror == request.mirror);
+	};
+	QMutexLocker lock(&_mutex);
+	if (same(_prepared.key, _prepared.size, _prepared.mirror)
+		|| (_waiting
+			&& same(
+				_waiting->original.cacheKey(),
+				_waiting->size,
+				_waiting->mirror))) {
+		return;
+	} else if (_waiting) {
+		++_dropped;
+	}
+	_waiting = std::move(request);
+	if (!_working) {
+		_working = true;
+		crl::async([weak = weak_from_this()] {
+			if (const auto strong = weak.lock()) {
+				strong->process();
+			}
+		});
+	}
+}
+
+void Viewport::RendererSW::FramePipeline::clear() {
+	QMutexLocker lock(&_mutex);
+	_waiting = std::nullopt;
+	_prepared = Prepared();
+}
+
+auto Viewport::RendererSW::FramePipeline::prepared() const -> Prepared {
+	QMutexLocker lock(&_mutex);
+	return _prepared;
+}
+
+void Viewport::RendererSW::FramePipeline::process() {
+	while (true) {
+		auto request = Request();
+		{
+			QMutexLocker lock(&_mutex);
+			if (!_waiting) {
+				_working = false;
+				return;
+			}
+			request = base::take(*_waiting);
+			_waiting = std::nullopt;
+		}
+		const auto started = crl::now();
+		auto image = request.original.scaled(
+			request.size,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation
+		).mirrored(request.mirror, false);
+		{
+			QMutexLocker lock(&_mutex);
+			_prepared = Prepared{
+				.image = std::move(image),
+				.key = request.original.cacheKey(),
+				.size = request.size,
+				.duration = crl::now() - started,
+				.dropped = _dropped,
+				.mirror = request.mirror,
+			};
+		}
+		crl::on_main([weak = weak_from_this(), rect = request.geometry] {
+			if (const auto strong = weak.lock()) {
+				strong->_ready(rect);
+			}
+		});
+	}
+}
+
 Viewport::RendererSW::RendererSW(not_null<Viewport*> owner)
 : _owner(owner)
 , _pinIcon(st::groupCallVideoTile.pin)
@@ -43,6 +176,7 @@ void Viewport::RendererSW::paintFallback(
 	auto bg = clip;
 	auto hq = PainterHighQualityEnabler(p);
 	const auto bounding = clip.boundingRect();
+	_frameTimes = OptionGroupCallFrameTimes.value();
 	for (auto &[tile, tileData] : _tileData) {
 		tileData.stale = true;
 	}
@@ -85,11 +219,53 @@ void Viewport::RendererSW::validateUserpicFrame(
 		kBlurRadius);
 }
 
+QImage Viewport::RendererSW::validateVideoFrame(
+		not_null<VideoTile*> tile,
+		TileData &data,
+		const Webrtc::FrameWithInfo &frame) {
+	using namespace Media::View;
+	const auto mirror = tile->mirror();
+	const auto geometry = tile->geometry();
+	const auto fit = FlipSizeByRotation(
+		frame.original.size(),
+		frame.rotation
+	).scaled(geometry.size(), Qt::KeepAspectRatio);
+	const auto size = FlipSizeByRotation(fit, frame.rotation)
+		* style::DevicePixelRatio();
+	if (size.isEmpty() || size.width() >= frame.original.width()) {
+		data.frames = nullptr;
+		return frame.original.mirrored(mirror, false);
+	} else if (!data.frames) {
+		const auto weak = Ui::MakeWeak(_owner->widget().get());
+		data.frames = std::make_shared<FramePipeline>([=](QRect rect) {
+			if (weak) {
+				weak->update(rect);
+			}
+		});
+	}
+	data.frames->request({
+		.original = frame.original,
+		.geometry = geometry,
+		.size = size,
+		.mirror = mirror,
+	});
+
+	// Until the current frame is scaled we show the previous one.
+	auto prepared = data.frames->prepared();
+	if (prepared.image.isNull()
+		|| prepared.size != size
+		|| prepared.mirror != mirror) {
+		return frame.original.mirrored(mirror, false);
+	}
+	return std::move(prepared.image);
+}
+
 void Viewport::RendererSW::paintTile(
 		Painter &p,
 		not_null<VideoTile*> tile,
 		const QRect &clip,
 		QRegion &bg) {
+	const auto started = _frameTimes ? crl::now() : crl::time();
 	const auto track = tile->track();
 	const auto markGuard = gsl::finally([&] {
 		tile->track()->markFrameShown();
@@ -109,11 +285,14 @@ void Viewport::RendererSW::paintTile(
 				Qt::KeepAspectRatio).mirrored(tile->mirror(), false),
 			kBlurRadius);
 	}
-	const auto &image = _userpicFrame
+	if (_userpicFrame || _pausedFrame) {
+		tileData.frames = nullptr;
+	}
+	const auto image = _userpicFrame
 		? tileData.userpicFrame
 		: _pausedFrame
 		? tileData.blurredFrame
-		: data.original.mirrored(tile->mirror(), false);
+		: validateVideoFrame(tile, tileData, data);
 	const auto frameRotation = _userpicFrame ? 0 : data.rotation;
 	Assert(!image.isNull());
 
@@ -172,6 +351,35 @@ void Viewport::RendererSW::paintTile(
 
 	paintTileControls(p, x, y, width, height, tile);
 	paintTileOutline(p, x, y, width, height, tile);
+	if (_frameTimes) {
+		tileData.paintDuration = crl::now() - started;
+		paintTileFrameTimes(p, x, y, tileData);
+	}
+}
+
+void Viewport::RendererSW::paintTileFrameTimes(
+		Painter &p,
+		int x,
+		int y,
+		const TileData &data) {
+	const auto prepared = data.frames
+		? data.frames->prepared()
+		: FramePipeline::Prepared();
+	const auto text = u"scale %1 ms, dropped %2, paint %3 ms"_q
+		.arg(prepared.duration)
+		.arg(prepared.dropped)
+		.arg(data.paintDuration);
+	const auto &font = st::normalFont;
+	const auto padding = font->height / 4;
+	p.fillRect(
+		x,
+		y,
+		font->width(text) + 2 * padding,
+		font->height + 2 * padding,
+		QColor(0, 0, 0, kShadowMaxAlpha));
+	p.setFont(font);
+	p.setPen(st::groupCallVideoTextFg);
+	p.drawText(x + padding, y + padding + font->ascent, text);
 }
 
 void Viewport::RendererSW::paintTileOutline(
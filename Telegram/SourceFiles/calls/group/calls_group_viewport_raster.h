@@ -13,6 +13,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/gl/gl_surface.h"
 #include "ui/text/text.h"
 
+namespace Webrtc {
+struct FrameWithInfo;
+} // namespace Webrtc
+
 namespace Calls::Group {
 
 class Viewport::RendererSW final : public Ui::GL::Renderer {
@@ -25,9 +29,12 @@ public:
 		Ui::GL::Backend backend) override;
 
 private:
+	class FramePipeline;
 	struct TileData {
 		QImage userpicFrame;
 		QImage blurredFrame;
+		std::shared_ptr<FramePipeline> frames;
+		crl::time paintDuration = 0;
 		bool stale = false;
 	};
 	void paintTile(
@@ -49,15 +56,25 @@ private:
 		int width,
 		int height,
 		not_null<VideoTile*> tile);
+	void paintTileFrameTimes(
+		Painter &p,
+		int x,
+		int y,
+		const TileData &data);
 	void validateUserpicFrame(
 		not_null<VideoTile*> tile,
 		TileData &data);
+	[[nodiscard]] QImage validateVideoFrame(
+		not_null<VideoTile*> tile,
+		TileData &data,
+		const Webrtc::FrameWithInfo &frame);
 
 	const not_null<Viewport*> _owner;
 
 	QImage _shadow;
 	bool _userpicFrame = false;
 	bool _pausedFrame = false;
+	bool _frameTimes = false;
 	base::flat_map<not_null<VideoTile*>, TileData> _tileData;
 	Ui::CrossLineAnimation _pinIcon;
 	Ui::RoundRect _pinBackground;
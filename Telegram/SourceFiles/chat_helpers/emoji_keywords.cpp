@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "chat_helpers/emoji_keywords.h"
 
+#include "chat_helpers/emoji_keywords_index.h"
 #include "emoji_suggestions_helper.h"
 #include "lang/lang_instance.h"
 #include "lang/lang_cloud_manager.h"
@@ -32,16 +33,12 @@ constexpr auto kKeepNotUsedInputLanguagesCount = 4;
 using namespace Ui::Emoji;
 
 using Result = EmojiKeywords::Result;
-
-struct LangPackEmoji {
-	EmojiPtr emoji = nullptr;
-	QString text;
-};
+using LangPackEmoji = details::EmojiKeywordsEntry;
+using LangPackIndex = details::EmojiKeywordsIndex;
 
 struct LangPackData {
 	int version = 0;
-	int maxKeyLength = 0;
-	std::map<QString, std::vector<LangPackEmoji>> emoji;
+	LangPackIndex index;
 };
 
 [[nodiscard]] bool MustAddPostfix(const QString &text) {
@@ -94,55 +91,23 @@ void CreateCacheFilePath() {
 	return internal::CacheFileFolder() + u"/keywords/"_q + id;
 }
 
+[[nodiscard]] EmojiPtr ResolveEmoji(const QString &text) {
+	return FindExact(MustAddPostfix(text)
+		? (text + QChar(Ui::Emoji::kPostfix))
+		: text);
+}
+
+// Caches of the older QDataStream format are rejected by the index,
+// such lang packs are requested from scratch.
 [[nodiscard]] LangPackData ReadLocalCache(const QString &id) {
-	auto file = QFile(CacheFilePath(id));
-	if (!file.open(QIODevice::ReadOnly)) {
-		return {};
-	}
 	auto result = LangPackData();
-	auto stream = QDataStream(&file);
-	stream.setVersion(QDataStream::Qt_5_1);
-	auto version = qint32();
-	auto count = qint32();
-	stream
-		>> version
-		>> count;
-	if (version < 0 || count < 0 || stream.status() != QDataStream::Ok) {
-		return {};
-	}
-	for (auto i = 0; i != count; ++i) {
-		auto key = QString();
-		auto size = qint32();
-		stream
-			>> key
-			>> size;
-		if (size < 0 || stream.status() != QDataStream::Ok) {
-			return {};
-		}
-		auto &list = result.emoji[key];
-		for (auto j = 0; j != size; ++j) {
-			auto text = QString();
-			stream >> text;
-			if (stream.status() != QDataStream::Ok) {
-				return {};
-			}
-			const auto emoji = MustAddPostfix(text)
-				? (text + QChar(Ui::Emoji::kPostfix))
-				: text;
-			const auto entry = LangPackEmoji{ FindExact(emoji), text };
-			if (!entry.emoji) {
-				return {};
-			}
-			list.push_back(entry);
-		}
-		result.maxKeyLength = std::max(result.maxKeyLength, int(key.size()));
-	}
-	result.version = version;
+	result.index = LangPackIndex::FromFile(CacheFilePath(id), ResolveEmoji);
+	result.version = result.index.version();
 	return result;
 }
 
-void WriteLocalCache(const QString &id, const LangPackData &data) {
-	if (!data.version && data.emoji.empty()) {
+void WriteLocalCache(const QString &id, const QByteArray &serialized) {
+	if (serialized.isEmpty()) {
 		return;
 	}
 	CreateCacheFilePath();
@@ -150,19 +115,7 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 	if (!file.open(QIODevice::WriteOnly)) {
 		return;
 	}
-	auto stream = QDataStream(&file);
-	stream.setVersion(QDataStream::Qt_5_1);
-	stream
-		<< qint32(data.version)
-		<< qint32(data.emoji.size());
-	for (const auto &[key, list] : data.emoji) {
-		stream
-			<< key
-			<< qint32(list.size());
-		for (const auto &emoji : list) {
-			stream << emoji.text;
-		}
-	}
+	file.write(serialized);
 }
 
 [[nodiscard]] QString NormalizeQuery(const QString &query) {
@@ -173,30 +126,6 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 	return key.toLower().trimmed();
 }
 
-void AppendFoundEmoji(
-		std::vector<Result> &result,
-		const QString &label,
-		const std::vector<LangPackEmoji> &list) {
-	// It is important that the 'result' won't relocate while inserting.
-	result.reserve(result.size() + list.size());
-	const auto alreadyBegin = begin(result);
-	const auto alreadyEnd = alreadyBegin + result.size();
-
-	auto &&add = ranges::views::all(
-		list
-	) | ranges::views::filter([&](const LangPackEmoji &entry) {
-		const auto i = ranges::find(
-			alreadyBegin,
-			alreadyEnd,
-			entry.emoji,
-			&Result::emoji);
-		return (i == alreadyEnd);
-	}) | ranges::views::transform([&](const LangPackEmoji &entry) {
-		return Result{ entry.emoji, label, entry.text };
-	});
-	result.insert(end(result), add.begin(), add.end());
-}
-
 void AppendLegacySuggestions(
 		std::vector<Result> &result,
 		const QString &query) {
@@ -241,26 +170,27 @@ void AppendLegacySuggestions(
 	result.insert(end(result), add.begin(), add.end());
 }
 
-void ApplyDifference(
+// Returns the serialized index for the local cache.
+[[nodiscard]] QByteArray ApplyDifference(
 		LangPackData &data,
 		const QVector<MTPEmojiKeyword> &keywords,
 		int version) {
-	data.version = version;
+	auto map = data.index.unpack();
+
+	// Release the (possibly mapped) cache file, it will be rewritten.
+	data.index = LangPackIndex();
 	for (const auto &keyword : keywords) {
 		keyword.match([&](const MTPDemojiKeyword &keyword) {
 			const auto word = NormalizeKey(qs(keyword.vkeyword()));
 			if (word.isEmpty()) {
 				return;
 			}
-			auto &list = data.emoji[word];
+			auto &list = map[word];
 			auto &&emoji = ranges::views::all(
 				keyword.vemoticons().v
 			) | ranges::views::transform([](const MTPstring &string) {
 				const auto text = qs(string);
-				const auto emoji = MustAddPostfix(text)
-					? (text + QChar(Ui::Emoji::kPostfix))
-					: text;
-				return LangPackEmoji{ FindExact(emoji), text };
+				return LangPackEmoji{ ResolveEmoji(text), text };
 			}) | ranges::views::filter([&](const LangPackEmoji &entry) {
 				if (!entry.emoji) {
 					LOG(("API Warning: emoji %1 is not supported, word: %2."
@@ -276,8 +206,8 @@ void ApplyDifference(
 			if (word.isEmpty()) {
 				return;
 			}
-			const auto i = data.emoji.find(word);
-			if (i == end(data.emoji)) {
+			const auto i = map.find(word);
+			if (i == end(map)) {
 				return;
 			}
 			auto &list = i->second;
@@ -287,20 +217,14 @@ void ApplyDifference(
 					end(list));
 			}
 			if (list.empty()) {
-				data.emoji.erase(i);
+				map.erase(i);
 			}
 		});
 	}
-	if (data.emoji.empty()) {
-		data.maxKeyLength = 0;
-	} else {
-		auto &&lengths = ranges::views::all(
-			data.emoji
-		) | ranges::views::transform([](auto &&pair) {
-			return pair.first.size();
-		});
-		data.maxKeyLength = *ranges::max_element(lengths);
-	}
+	auto result = LangPackIndex::Serialize(version, map);
+	data.version = version;
+	data.index = LangPackIndex::FromBytes(result, ResolveEmoji);
+	return result;
 }
 
 } // namespace
@@ -319,7 +243,11 @@ public:
 	void refresh();
 	void apiChanged();
 
-	[[nodiscard]] std::vector<Result> query(
+	// Appends emoji not yet in 'added', so that all lang packs
+	// fill a single result list.
+	void query(
+		std::vector<Result> &result,
+		base::flat_set<EmojiPtr> &added,
 		const QString &normalized,
 		bool exact) const;
 	[[nodiscard]] int maxQueryLength() const;
@@ -442,13 +370,18 @@ void EmojiKeywords::LangPack::applyDifference(
 		crl::async([=,
 			copy = std::move(copy),
 			callback = std::move(callback)]() mutable {
-			ApplyDifference(copy, keywords, version);
-			WriteLocalCache(id, copy);
+			auto serialized = ApplyDifference(copy, keywords, version);
 			crl::on_main([
+				id,
 				result = std::move(copy),
+				serialized = std::move(serialized),
 				callback = std::move(callback)
 			]() mutable {
+				// Write after the old mapping of the file is released.
 				callback(std::move(result));
+				crl::async([=] {
+					WriteLocalCache(id, serialized);
+				});
 			});
 		});
 	});
@@ -470,33 +403,30 @@ void EmojiKeywords::LangPack::apiChanged() {
 	refresh();
 }
 
-std::vector<Result> EmojiKeywords::LangPack::query(
+void EmojiKeywords::LangPack::query(
+		std::vector<Result> &result,
+		base::flat_set<EmojiPtr> &added,
 		const QString &normalized,
 		bool exact) const {
-	if (normalized.size() > _data.maxKeyLength
-		|| _data.emoji.empty()
+	if (normalized.size() > _data.index.maxKeyLength()
+		|| _data.index.empty()
 		|| (exact && SkipExactKeyword(_id, normalized))) {
-		return {};
+		return;
 	}
-
-	const auto from = _data.emoji.lower_bound(normalized);
-	auto &&chosen = ranges::make_subrange(
-		from,
-		end(_data.emoji)
-	) | ranges::views::take_while([&](const auto &pair) {
-		const auto &key = pair.first;
-		return exact ? (key == normalized) : key.startsWith(normalized);
+	auto label = QString();
+	_data.index.enumerate(normalized, exact, [&](
+			const LangPackIndex::Found &found) {
+		if (!added.emplace(found.emoji).second) {
+			return;
+		} else if (label != found.key) {
+			label = found.key.toString();
+		}
+		result.push_back({ found.emoji, label, found.text.toString() });
 	});
-
-	auto result = std::vector<Result>();
-	for (const auto &[key, list] : chosen) {
-		AppendFoundEmoji(result, key, list);
-	}
-	return result;
 }
 
 int EmojiKeywords::LangPack::maxQueryLength() const {
-	return _data.maxKeyLength;
+	return _data.index.maxKeyLength();
 }
 
 EmojiKeywords::EmojiKeywords() {
@@ -613,27 +543,9 @@ std::vector<Result> EmojiKeywords::query(
 		return {};
 	}
 	auto result = std::vector<Result>();
+	auto added = base::flat_set<EmojiPtr>();
 	for (const auto &[language, item] : _data) {
-		const auto list = item->query(normalized, exact);
-
-		// It is important that the 'result' won't relocate while inserting.
-		result.reserve(result.size() + list.size());
-		const auto alreadyBegin = begin(result);
-		const auto alreadyEnd = alreadyBegin + result.size();
-
-		auto &&add = ranges::views::all(
-			list
-		) | ranges::views::filter([&](Result entry) {
-			// In each item->query() result the list has no duplicates.
-			// So we need to check only for duplicates between queries.
-			const auto i = ranges::find(
-				alreadyBegin,
-				alreadyEnd,
-				entry.emoji,
-				&Result::emoji);
-			return (i == alreadyEnd);
-		});
-		result.insert(end(result), add.begin(), add.end());
+		item->query(result, added, normalized, exact);
 	}
 	if (!exact) {
 		AppendLegacySuggestions(result, query);
@@ -0,0 +1,446 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "chat_helpers/emoji_keywords_index.h"
+
+namespace ChatHelpers::details {
+namespace {
+
+constexpr auto kMagic = uint32(0x4B454454); // "TDEK"
+constexpr auto kFormat = uint32(1);
+constexpr auto kBlockSize = 16;
+constexpr auto kMaxKeyLength = 255;
+constexpr auto kMaxTexts = 0x10000;
+constexpr auto kMaxFileSize = int64(64 * 1024 * 1024);
+
+// Layout, each section is padded to four bytes:
+//   RawHeader
+//   uint32 blockOffsets[blocksCount] - into 'keys', each kBlockSize keys.
+//   uint32 postingStarts[keysCount + 1] - into 'postings'.
+//   uint32 textStarts[textsCount + 1] - into 'textChars'.
+//   uint16 postings[postingsCount] - indices of emoji texts.
+//   char16_t textChars[textCharsCount]
+//   keys[keysBytes] - { uint8 shared, uint8 length, char16_t[length] }.
+// A key shares 'shared' first chars with the previous key in its block.
+struct RawHeader {
+	uint32 magic = 0;
+	uint32 format = 0;
+	int32 version = 0;
+	int32 keysCount = 0;
+	int32 maxKeyLength = 0;
+	int32 blocksCount = 0;
+	int32 keysBytes = 0;
+	int32 postingsCount = 0;
+	int32 textsCount = 0;
+	int32 textCharsCount = 0;
+};
+static_assert(sizeof(RawHeader) % 4 == 0);
+
+[[nodiscard]] int64 Padded(int64 size) {
+	return (size + 3) & ~int64(3);
+}
+
+void Append(QByteArray &result, const void *data, int64 size) {
+	result.append(reinterpret_cast<const char*>(data), size);
+	while (result.size() % 4) {
+		result.append(char(0));
+	}
+}
+
+[[nodiscard]] int CommonPrefix(QStringView a, QStringView b) {
+	const auto limit = std::min(a.size(), b.size());
+	auto result = qsizetype(0);
+	while (result < limit && a[result] == b[result]) {
+		++result;
+	}
+	return int(result);
+}
+
+class KeyReader final {
+public:
+	KeyReader(const uchar *keys, int size) : _keys(keys), _size(size) {
+	}
+
+	// Keys are decoded only from the block starts.
+	void seek(uint32 offset) {
+		_offset = int(std::min(offset, uint32(_size)));
+		_length = 0;
+	}
+	[[nodiscard]] bool next() {
+		if (_size - _offset < 2) {
+			return false;
+		}
+		const auto shared = int(_keys[_offset]);
+		const auto length = int(_keys[_offset + 1]);
+		if (shared > _length
+			|| shared + length > kMaxKeyLength
+			|| _size - _offset - 2 < length * 2) {
+			return false;
+		}
+		memcpy(
+			_buffer.data() + shared,
+			_keys + _offset + 2,
+			length * sizeof(char16_t));
+		_length = shared + length;
+		_offset += 2 + length * 2;
+		return true;
+	}
+	[[nodiscard]] uint32 offset() const {
+		return uint32(_offset);
+	}
+	[[nodiscard]] QStringView key() const {
+		return QStringView(_buffer.data(), _length);
+	}
+
+private:
+	const uchar *_keys = nullptr;
+	int _size = 0;
+	int _offset = 0;
+	int _length = 0;
+	std::array<char16_t, kMaxKeyLength> _buffer = {};
+
+};
+
+} // namespace
+
+struct EmojiKeywordsIndex::Storage {
+	QByteArray bytes;
+	std::unique_ptr<QFile> file;
+	RawHeader header;
+	const uint32 *blockOffsets = nullptr;
+	const uint32 *postingStarts = nullptr;
+	const uint32 *textStarts = nullptr;
+	const uint16 *postings = nullptr;
+	const char16_t *textChars = nullptr;
+	const uchar *keys = nullptr;
+	std::vector<EmojiPtr> emoji;
+};
+
+QByteArray EmojiKeywordsIndex::Serialize(
+		int version,
+		const EmojiKeywordsMap &map) {
+	auto header = RawHeader();
+	header.magic = kMagic;
+	header.format = kFormat;
+	header.version = version;
+
+	auto blockOffsets = std::vector<uint32>();
+	auto postingStarts = std::vector<uint32>();
+	auto textStarts = std::vector<uint32>{ 0 };
+	auto postings = std::vector<uint16>();
+	auto textChars = QString();
+	auto keys = QByteArray();
+	auto texts = base::flat_map<QString, uint16>();
+	auto previous = QStringView();
+	for (const auto &[key, list] : map) {
+		if (key.isEmpty() || key.size() > kMaxKeyLength || list.empty()) {
+			continue;
+		} else if (!(header.keysCount % kBlockSize)) {
+			blockOffsets.push_back(keys.size());
+			previous = QStringView();
+		}
+		postingStarts.push_back(postings.size());
+		for (const auto &entry : list) {
+			auto i = texts.find(entry.text);
+			if (i == end(texts)) {
+				if (int(texts.size()) >= kMaxTexts) {
+					LOG(("Emoji Keywords Error: Too many emoji texts."));
+					return QByteArray();
+				}
+				i = texts.emplace(entry.text, uint16(texts.size())).first;
+				textChars.append(entry.text);
+				textStarts.push_back(textChars.size());
+			}
+			postings.push_back(i->second);
+		}
+		const auto shared = CommonPrefix(previous, key);
+		const auto length = int(key.size()) - shared;
+		keys.append(char(uchar(shared)));
+		keys.append(char(uchar(length)));
+		keys.append(
+			reinterpret_cast<const char*>(key.constData() + shared),
+			length * sizeof(char16_t));
+		previous = key;
+		++header.keysCount;
+		header.maxKeyLength = std::max(header.maxKeyLength, int(key.size()));
+	}
+	postingStarts.push_back(postings.size());
+
+	header.blocksCount = blockOffsets.size();
+	header.keysBytes = keys.size();
+	header.postingsCount = postings.size();
+	header.textsCount = texts.size();
+	header.textCharsCount = textChars.size();
+
+	auto result = QByteArray();
+	Append(result, &header, sizeof(header));
+	Append(
+		result,
+		blockOffsets.data(),
+		blockOffsets.size() * sizeof(uint32));
+	Append(
+		result,
+		postingStarts.data(),
+		postingStarts.size() * sizeof(uint32));
+	Append(result, textStarts.data(), textStarts.size() * sizeof(uint32));
+	Append(result, postings.data(), postings.size() * sizeof(uint16));
+	Append(result, textChars.constData(), textChars.size() * sizeof(QChar));
+	Append(result, keys.constData(), keys.size());
+	return result;
+}
+
+EmojiKeywordsIndex EmojiKeywordsIndex::FromBytes(
+		const QByteArray &bytes,
+		const Resolve &resolve) {
+	auto storage = std::make_shared<Storage>();
+	storage->bytes = bytes;
+	const auto data = reinterpret_cast<const uchar*>(
+		storage->bytes.constData());
+	const auto size = int64(storage->bytes.size());
+	return Parse(std::move(storage), data, size, resolve);
+}
+
+EmojiKeywordsIndex EmojiKeywordsIndex::FromFile(
+		const QString &path,
+		const Resolve &resolve) {
+	auto file = std::make_unique<QFile>(path);
+	if (!file->open(QIODevice::ReadOnly)) {
+		return {};
+	}
+	const auto size = file->size();
+	if (size < int64(sizeof(RawHeader)) || size > kMaxFileSize) {
+		return {};
+	}
+	const auto data = file->map(0, size);
+	if (!data) {
+		return FromBytes(file->readAll(), resolve);
+	}
+	auto storage = std::make_shared<Storage>();
+
+	// The mapping lives while the file is open.
+	storage->file = std::move(file);
+	return Parse(std::move(storage), data, size, resolve);
+}
+
+EmojiKeywordsIndex EmojiKeywordsIndex::Parse(
+		std::shared_ptr<Storage> storage,
+		const uchar *data,
+		int64 size,
+		const Resolve &resolve) {
+	if (size < int64(sizeof(RawHeader))) {
+		return {};
+	}
+	auto &header = storage->header;
+	memcpy(&header, data, sizeof(RawHeader));
+	if (header.magic != kMagic
+		|| header.format != kFormat
+		|| header.version < 0
+		|| header.keysCount < 0
+		|| header.keysBytes < 0
+		|| header.postingsCount < 0
+		|| header.textsCount < 0
+		|| header.textsCount > kMaxTexts
+		|| header.textCharsCount < 0
+		|| (header.blocksCount
+			!= (header.keysCount + kBlockSize - 1) / kBlockSize)) {
+		return {};
+	}
+	const auto sizes = std::array{
+		Padded(sizeof(RawHeader)),
+		Padded(header.blocksCount * int64(sizeof(uint32))),
+		Padded((header.keysCount + int64(1)) * sizeof(uint32)),
+		Padded((header.textsCount + int64(1)) * sizeof(uint32)),
+		Padded(header.postingsCount * int64(sizeof(uint16))),
+		Padded(header.textCharsCount * int64(sizeof(char16_t))),
+		Padded(header.keysBytes),
+	};
+	if (ranges::accumulate(sizes, int64(0)) != size) {
+		return {};
+	}
+	auto offset = int64(0);
+	const auto take = [&](int section) {
+		offset += sizes[section - 1];
+		return data + offset;
+	};
+	storage->blockOffsets = reinterpret_cast<const uint32*>(take(1));
+	storage->postingStarts = reinterpret_cast<const uint32*>(take(2));
+	storage->textStarts = reinterpret_cast<const uint32*>(take(3));
+	storage->postings = reinterpret_cast<const uint16*>(take(4));
+	storage->textChars = reinterpret_cast<const char16_t*>(take(5));
+	storage->keys = take(6);
+
+	const auto ordered = [](const uint32 *list, int count, uint32 last) {
+		if (list[0] != 0 || list[count] != last) {
+			return false;
+		}
+		for (auto i = 0; i != count; ++i) {
+			if (list[i] >= list[i + 1]) {
+				return false;
+			}
+		}
+		return true;
+	};
+	if (!ordered(
+			storage->postingStarts,
+			header.keysCount,
+			uint32(header.postingsCount))
+		|| !ordered(
+			storage->textStarts,
+			header.textsCount,
+			uint32(header.textCharsCount))) {
+		return {};
+	}
+	for (auto i = 0; i != header.postingsCount; ++i) {
+		if (storage->postings[i] >= header.textsCount) {
+			return {};
+		}
+	}
+
+	auto reader = KeyReader(storage->keys, header.keysBytes);
+	auto previous = std::array<char16_t, kMaxKeyLength>();
+	auto previousLength = 0;
+	auto maxKeyLength = 0;
+	for (auto i = 0; i != header.keysCount; ++i) {
+		if (!(i % kBlockSize)) {
+			if (storage->blockOffsets[i / kBlockSize] != reader.offset()) {
+				return {};
+			}
+			reader.seek(reader.offset());
+		}
+		if (!reader.next()) {
+			return {};
+		}
+		const auto key = reader.key();
+		const auto was = QStringView(previous.data(), previousLength);
+		if (key.isEmpty() || (i > 0 && key.compare(was) <= 0)) {
+			return {};
+		}
+		previousLength = int(key.size());
+		memcpy(previous.data(), key.data(), key.size() * sizeof(char16_t));
+		maxKeyLength = std::max(maxKeyLength, previousLength);
+	}
+	if (reader.offset() != uint32(header.keysBytes)
+		|| maxKeyLength != header.maxKeyLength) {
+		return {};
+	}
+
+	auto result = EmojiKeywordsIndex();
+	result._storage = storage;
+	storage->emoji.reserve(header.textsCount);
+	for (auto i = 0; i != header.textsCount; ++i) {
+		const auto emoji = resolve(result.text(i).toString());
+		if (!emoji) {
+			return {};
+		}
+		storage->emoji.push_back(emoji);
+	}
+	return result;
+}
+
+bool EmojiKeywordsIndex::empty() const {
+	return !_storage || !_storage->header.keysCount;
+}
+
+int EmojiKeywordsIndex::version() const {
+	return _storage ? _storage->header.version : 0;
+}
+
+int EmojiKeywordsIndex::maxKeyLength() const {
+	return _storage ? _storage->header.maxKeyLength : 0;
+}
+
+QStringView EmojiKeywordsIndex::text(int index) const {
+	const auto &storage = *_storage;
+	const auto from = storage.textStarts[index];
+	const auto till = storage.textStarts[index + 1];
+	return QStringView(storage.textChars + from, till - from);
+}
+
+EmojiKeywordsMap EmojiKeywordsIndex::unpack() const {
+	auto result = EmojiKeywordsMap();
+	if (empty()) {
+		return result;
+	}
+	const auto &storage = *_storage;
+	const auto &header = storage.header;
+	auto reader = KeyReader(storage.keys, header.keysBytes);
+	for (auto i = 0; i != header.keysCount; ++i) {
+		if (!(i % kBlockSize)) {
+			reader.seek(storage.blockOffsets[i / kBlockSize]);
+		}
+		if (!reader.next()) {
+			break;
+		}
+		auto &list = result.emplace_hint(
+			end(result),
+			reader.key().toString(),
+			std::vector<EmojiKeywordsEntry>())->second;
+		const auto from = storage.postingStarts[i];
+		const auto till = storage.postingStarts[i + 1];
+		list.reserve(till - from);
+		for (auto j = from; j != till; ++j) {
+			const auto index = storage.postings[j];
+			list.push_back({ storage.emoji[index], text(index).toString() });
+		}
+	}
+	return result;
+}
+
+void EmojiKeywordsIndex::enumerate(
+		QStringView normalized,
+		bool exact,
+		FnMut<void(const Found &found)> callback) const {
+	if (empty()
+		|| normalized.isEmpty()
+		|| normalized.size() > maxKeyLength()) {
+		return;
+	}
+	const auto &storage = *_storage;
+	const auto &header = storage.header;
+	auto reader = KeyReader(storage.keys, header.keysBytes);
+
+	// Find the first block that starts with a key after the query,
+	// the matching keys start in the block right before it.
+	const auto startsAfter = [&](int block) {
+		reader.seek(storage.blockOffsets[block]);
+		return reader.next() && (reader.key().compare(normalized) > 0);
+	};
+	auto left = 0;
+	auto right = header.blocksCount;
+	while (left < right) {
+		const auto middle = (left + right) / 2;
+		if (startsAfter(middle)) {
+			right = middle;
+		} else {
+			left = middle + 1;
+		}
+	}
+	const auto from = std::max(left - 1, 0) * kBlockSize;
+	for (auto i = from; i != header.keysCount; ++i) {
+		if (!(i % kBlockSize)) {
+			reader.seek(storage.blockOffsets[i / kBlockSize]);
+		}
+		if (!reader.next()) {
+			return;
+		}
+		const auto key = reader.key();
+		if (key.compare(normalized) < 0) {
+			continue;
+		} else if (exact
+			? (key != normalized)
+			: !key.startsWith(normalized)) {
+			return;
+		}
+		const auto till = storage.postingStarts[i + 1];
+		for (auto j = storage.postingStarts[i]; j != till; ++j) {
+			const auto index = storage.postings[j];
+			callback(Found{ key, storage.emoji[index], text(index) });
+		}
+	}
+}
+
+} // namespace ChatHelpers::details
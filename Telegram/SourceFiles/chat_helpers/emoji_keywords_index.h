@@ -0,0 +1,73 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace ChatHelpers::details {
+
+struct EmojiKeywordsEntry {
+	EmojiPtr emoji = nullptr;
+	QString text;
+};
+
+using EmojiKeywordsMap = std::map<QString, std::vector<EmojiKeywordsEntry>>;
+
+// Immutable sorted keyword index in a flat format without pointers.
+// Keys are prefix compressed in small blocks, so the index is used
+// right from the (memory mapped) cache file without building QString-s.
+class EmojiKeywordsIndex final {
+public:
+	using Resolve = Fn<EmojiPtr(const QString &text)>;
+
+	EmojiKeywordsIndex() = default;
+
+	[[nodiscard]] static QByteArray Serialize(
+		int version,
+		const EmojiKeywordsMap &map);
+	[[nodiscard]] static EmojiKeywordsIndex FromBytes(
+		const QByteArray &bytes,
+		const Resolve &resolve);
+	[[nodiscard]] static EmojiKeywordsIndex FromFile(
+		const QString &path,
+		const Resolve &resolve);
+
+	[[nodiscard]] bool empty() const;
+	[[nodiscard]] int version() const;
+	[[nodiscard]] int maxKeyLength() const;
+
+	[[nodiscard]] EmojiKeywordsMap unpack() const;
+
+	struct Found {
+		QStringView key;
+		EmojiPtr emoji = nullptr;
+		QStringView text;
+	};
+
+	// Calls 'callback' in the keys order for each emoji of each keyword
+	// equal to (exact) or starting with the normalized query.
+	// Views in 'Found' are valid only during the 'callback' call.
+	void enumerate(
+		QStringView normalized,
+		bool exact,
+		FnMut<void(const Found &found)> callback) const;
+
+private:
+	struct Storage;
+
+	[[nodiscard]] static EmojiKeywordsIndex Parse(
+		std::shared_ptr<Storage> storage,
+		const uchar *data,
+		int64 size,
+		const Resolve &resolve);
+
+	[[nodiscard]] QStringView text(int index) const;
+
+	std::shared_ptr<const Storage> _storage;
+
+};
+
+} // namespace ChatHelpers::details
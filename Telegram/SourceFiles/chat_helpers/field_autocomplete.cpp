@@ -151,7 +151,6 @@ private:
 	const not_null<StickerRows*> _srows;
 	Ui::RoundRect _overBg;
 	rpl::lifetime _stickersLifetime;
-	std::weak_ptr<Lottie::FrameRenderer> _lottieRenderer;
 	base::unique_qptr<Ui::PopupMenu> _menu;
 	int _stickersPerRow = 1;
 	int _recentInlineBotsInRows = 0;
@@ -1470,12 +1469,7 @@ void FieldAutocomplete::Inner::rowsUpdated() {
 
 auto FieldAutocomplete::Inner::getLottieRenderer()
 -> std::shared_ptr<Lottie::FrameRenderer> {
-	if (auto result = _lottieRenderer.lock()) {
-		return result;
-	}
-	auto result = Lottie::MakeFrameRenderer();
-	_lottieRenderer = result;
-	return result;
+	return PanelsLottieRenderer();
 }
 
 void FieldAutocomplete::Inner::setupLottie(StickerSuggestion &suggestion) {
@@ -1056,12 +1056,7 @@ void StickersListFooter::updateSelected() {
 
 auto StickersListFooter::getLottieRenderer()
 -> std::shared_ptr<Lottie::FrameRenderer> {
-	if (auto result = _lottieRenderer.lock()) {
-		return result;
-	}
-	auto result = Lottie::MakeFrameRenderer();
-	_lottieRenderer = result;
-	return result;
+	return PanelsLottieRenderer();
 }
 
 void StickersListFooter::refreshIcons(
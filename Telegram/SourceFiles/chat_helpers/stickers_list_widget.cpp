@@ -65,6 +65,7 @@ constexpr auto kPreloadOfficialPages = 4;
 constexpr auto kOfficialLoadLimit = 40;
 constexpr auto kMinRepaintDelay = crl::time(33);
 constexpr auto kMinAfterScrollDelay = crl::time(33);
+constexpr auto kLottieSetupsPerPaint = 4;
 
 using Data::StickersSet;
 using Data::StickersPack;
@@ -932,6 +933,9 @@ void StickersListWidget::paintStickers(Painter &p, QRect clip) {
 	const auto now = crl::now();
 	const auto paused = On(PowerSaving::kStickersPanel)
 		|| this->paused();
+	_lottieSetupsLeft = kLottieSetupsPerPaint;
+	_lottieSetupsPostponed = false;
+	_lottieShownInPaint = 0;
 	if (sets.empty() && _section == Section::Search) {
 		paintEmptySearchResults(p);
 	}
@@ -1127,6 +1131,14 @@ void StickersListWidget::paintStickers(Painter &p, QRect clip) {
 		}
 		return true;
 	});
+	if (_lottieSetupsPostponed) {
+		// Create the rest of the animations on the next frames,
+		// so that opening the panel doesn't parse all of them at once.
+		_updateItemsTimer.callOnce(kMinRepaintDelay);
+	}
+	if (_lottieShownInPaint > 0) {
+		ReportPanelsPaintCost(crl::now() - now, _lottieShownInPaint);
+	}
 }
 
 void StickersListWidget::markLottieFrameShown(Set &set) {
@@ -1148,6 +1160,9 @@ void StickersListWidget::checkVisibleLottie() {
 		if (destroyBelow <= info.rowsTop
 			|| destroyAbove >= info.rowsBottom) {
 			clearHeavyIn(shownSets()[info.section]);
+		} else if (visibleBottom <= info.rowsTop
+			|| visibleTop >= info.rowsBottom) {
+			pauseAllLottieIn(shownSets()[info.section]);
 		} else if ((visibleTop > info.rowsTop && visibleTop < info.rowsBottom)
 			|| (visibleBottom > info.rowsTop
 				&& visibleBottom < info.rowsBottom)) {
@@ -1157,6 +1172,18 @@ void StickersListWidget::checkVisibleLottie() {
 	});
 }
 
+void StickersListWidget::pauseAllLottieIn(Set &set) {
+	const auto player = set.lottiePlayer.get();
+	if (!player) {
+		return;
+	}
+	for (const auto &sticker : set.stickers) {
+		if (const auto animated = sticker.lottie) {
+			player->pause(animated);
+		}
+	}
+}
+
 void StickersListWidget::clearHeavyIn(Set &set, bool clearSavedFrames) {
 	const auto player = base::take(set.lottiePlayer);
 	const auto lifetime = base::take(set.lottieLifetime);
@@ -1451,7 +1478,12 @@ void StickersListWidget::paintSticker(
 	if (isLottie
 		&& !sticker.lottie
 		&& media->loaded()) {
-		setupLottie(set, section, index);
+		if (_lottieSetupsLeft > 0) {
+			--_lottieSetupsLeft;
+			setupLottie(set, section, index);
+		} else {
+			_lottieSetupsPostponed = true;
+		}
 	} else if (isWebm && !sticker.webm && media->loaded()) {
 		setupWebm(set, section, index);
 	}
@@ -1486,6 +1518,7 @@ void StickersListWidget::paintSticker(
 			sticker.savedFrameFor = _singleSize;
 		}
 		set.lottiePlayer->unpause(sticker.lottie);
+		++_lottieShownInPaint;
 	} else if (sticker.webm && sticker.webm->started()) {
 		const auto frame = sticker.webm->current(
 			{ .frame = size, .keepAlpha = true },
@@ -2669,12 +2702,7 @@ void StickersListWidget::showPreview() {
 
 auto StickersListWidget::getLottieRenderer()
 -> std::shared_ptr<Lottie::FrameRenderer> {
-	if (auto result = _lottieRenderer.lock()) {
-		return result;
-	}
-	auto result = Lottie::MakeFrameRenderer();
-	_lottieRenderer = result;
-	return result;
+	return PanelsLottieRenderer();
 }
 
 void StickersListWidget::showStickerSet(uint64 setId) {
@@ -300,6 +300,7 @@ private:
 	void markLottieFrameShown(Set &set);
 	void checkVisibleLottie();
 	void pauseInvisibleLottieIn(const SectionInfo &info);
+	void pauseAllLottieIn(Set &set);
 	void takeHeavyData(std::vector<Set> &to, std::vector<Set> &from);
 	void takeHeavyData(Set &to, Set &from);
 	void takeHeavyData(Sticker &to, Sticker &from);
@@ -389,12 +390,14 @@ private:
 	std::vector<bool> _custom;
 	std::vector<EmojiPtr> _cornerEmoji;
 	base::flat_set<not_null<DocumentData*>> _favedStickersMap;
-	std::weak_ptr<Lottie::FrameRenderer> _lottieRenderer;
 
 	bool _paintAsPremium = false;
 	bool _showingSetById = false;
 	crl::time _lastScrolledAt = 0;
 	crl::time _lastFullUpdatedAt = 0;
+	int _lottieSetupsLeft = 0;
+	int _lottieShownInPaint = 0;
+	bool _lottieSetupsPostponed = false;
 
 	mtpRequestId _officialRequestId = 0;
 	int _officialOffset = 0;
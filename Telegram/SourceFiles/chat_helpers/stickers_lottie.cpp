@@ -30,6 +30,15 @@ namespace ChatHelpers {
 namespace {
 
 constexpr auto kDontCacheLottieAfterArea = 512 * 512;
+constexpr auto kPaintCostReportPeriod = crl::time(5000);
+
+struct PaintCostStats {
+	crl::time periodStart = 0;
+	crl::time total = 0;
+	crl::time maximum = 0;
+	int frames = 0;
+	int animations = 0;
+};
 
 [[nodiscard]] uint64 LocalStickerId(QStringView name) {
 	auto full = u"local_sticker:"_q;
@@ -43,6 +52,42 @@ uint8 LottieCacheKeyShift(uint8 replacementsTag, StickerLottieSize sizeTag) {
 	return ((replacementsTag << 4) & 0xF0) | (uint8(sizeTag) & 0x0F);
 }
 
+std::shared_ptr<Lottie::FrameRenderer> PanelsLottieRenderer() {
+	static auto Shared = std::weak_ptr<Lottie::FrameRenderer>();
+	if (auto result = Shared.lock()) {
+		return result;
+	}
+	auto result = Lottie::MakeFrameRenderer();
+	Shared = result;
+	return result;
+}
+
+void ReportPanelsPaintCost(crl::time duration, int animationsShown) {
+	if (!Logs::DebugEnabled()) {
+		return;
+	}
+	static auto Stats = PaintCostStats();
+	const auto now = crl::now();
+	if (!Stats.periodStart) {
+		Stats.periodStart = now;
+	}
+	Stats.total += duration;
+	Stats.maximum = std::max(Stats.maximum, duration);
+	Stats.animations += animationsShown;
+	++Stats.frames;
+	if (now - Stats.periodStart < kPaintCostReportPeriod) {
+		return;
+	}
+	DEBUG_LOG(("Stickers Panels: %1 frames in %2 ms, "
+		"paint total %3 ms, max %4 ms, %5 animations per frame."
+		).arg(Stats.frames
+		).arg(now - Stats.periodStart
+		).arg(Stats.total
+		).arg(Stats.maximum
+		).arg(Stats.animations / float64(Stats.frames), 0, 'f', 1));
+	Stats = PaintCostStats();
+}
+
 template <typename Method>
 auto LottieCachedFromContent(
 		Method &&method,
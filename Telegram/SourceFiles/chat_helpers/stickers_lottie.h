@@ -73,6 +73,13 @@ enum class StickerLottieSize : uint8 {
 	uint8 replacementsTag,
 	StickerLottieSize sizeTag);
 
+// All sticker panels (list, footer, autocomplete, set box) share a single
+// renderer, so expanding many animated sets doesn't add rendering threads.
+[[nodiscard]] std::shared_ptr<Lottie::FrameRenderer> PanelsLottieRenderer();
+
+// Accumulates paint time of animated panels, reported to the debug log.
+void ReportPanelsPaintCost(crl::time duration, int animationsShown);
+
 [[nodiscard]] std::unique_ptr<Lottie::SinglePlayer> LottiePlayerFromDocument(
 	not_null<Data::DocumentMedia*> media,
 	StickerLottieSize sizeTag,
@@ -20,6 +20,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/timer.h"
 #include "base/unixtime.h"
 #include "core/core_settings.h"
+#include "core/startup_trace.h"
 #include "core/update_checker.h"
 #include "core/shortcuts.h"
 #include "core/sandbox.h"
@@ -257,7 +258,10 @@ void Application::run() {
 	// Depends on notifications settings.
 	_notifications = std::make_unique<Window::Notifications::System>();
 
-	startLocalStorage();
+	{
+		const auto trace = StartupTrace::Span("startLocalStorage");
+		startLocalStorage();
+	}
 
 	style::SetCustomFont(settings().customFontFamily());
 	style::internal::StartFonts();
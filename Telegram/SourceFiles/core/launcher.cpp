@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/crash_reports.h"
 #include "core/update_checker.h"
 #include "core/sandbox.h"
+#include "core/startup_trace.h"
 #include "base/concurrent_timer.h"
 #include "base/options.h"
 
@@ -388,9 +389,13 @@ int Launcher::exec() {
 	}
 
 	// Must be started before Sandbox is created.
-	Platform::start();
-	ThirdParty::start();
+	{
+		const auto trace = StartupTrace::Span("Platform::start");
+		Platform::start();
+		ThirdParty::start();
+	}
 	auto result = executeApplication();
+	StartupTrace::Dump();
 
 	DEBUG_LOG(("Telegram finished, result: %1").arg(result));
 
@@ -540,6 +545,7 @@ void Launcher::processArguments() {
 		{ "-workdir"        , KeyFormat::OneValue },
 		{ "--"              , KeyFormat::OneValue },
 		{ "-scale"          , KeyFormat::OneValue },
+		{ "-tracestartup"   , KeyFormat::OneValue },
 	};
 	auto parseResult = QMap<QByteArray, QStringList>();
 	auto parsingKey = QByteArray();
@@ -585,6 +591,8 @@ void Launcher::processArguments() {
 		_customWorkingDir = QDir(_customWorkingDir).absolutePath() + '/';
 	}
 	gStartUrl = parseResult.value("--", {}).join(QString());
+	StartupTrace::Start(
+		parseResult.value("-tracestartup", {}).join(QString()));
 
 	const auto scaleKey = parseResult.value("-scale", {});
 	if (scaleKey.size() > 0) {
@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/crash_report_window.h"
 #include "core/application.h"
 #include "core/launcher.h"
+#include "core/startup_trace.h"
 #include "core/local_url_handlers.h"
 #include "core/update_checker.h"
 #include "core/deadlock_detector.h"
@@ -197,7 +198,10 @@ void Sandbox::launchApplication() {
 		}
 #endif // !_DEBUG
 
-		_application = std::make_unique<Application>();
+		{
+			const auto trace = StartupTrace::Span("Application()");
+			_application = std::make_unique<Application>();
+		}
 
 		// Ideally this should go to constructor.
 		// But we want to catch all native events and Application installs
@@ -205,6 +209,7 @@ void Sandbox::launchApplication() {
 		// our filter after the Application constructor installs his.
 		installNativeEventFilter(this);
 
+		const auto trace = StartupTrace::Span("Application::run");
 		_application->run();
 	});
 }
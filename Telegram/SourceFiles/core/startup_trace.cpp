@@ -0,0 +1,205 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/startup_trace.h"
+
+#include "core/application.h"
+#include "base/call_delayed.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <chrono>
+
+namespace Core::StartupTrace {
+namespace {
+
+// Final milestones, the trace is written when all of them are marked.
+// Opening a chat is recorded if it happens before that, but isn't
+// waited for, so that an unattended run finishes by itself.
+constexpr auto kFinishAfter = std::array{
+	"Dialogs::painted",
+	"Updates::differenceDone",
+};
+
+// Counted from the first chats list paint, if some milestone never comes.
+constexpr auto kFinishTimeout = 60 * crl::time(1000);
+
+struct Event {
+	const char *name = nullptr;
+	int64 start = 0;
+	int64 duration = -1;
+	int thread = 0;
+};
+
+std::atomic<bool> Started = false;
+std::chrono::steady_clock::time_point StartTime;
+QString Path;
+QMutex Mutex;
+std::vector<Event> Events;
+base::flat_set<QByteArray> MarkedFirst;
+bool Dumped = false;
+
+[[nodiscard]] int64 Now() {
+	using namespace std::chrono;
+	const auto passed = steady_clock::now() - StartTime;
+	return duration_cast<microseconds>(passed).count();
+}
+
+[[nodiscard]] int ThreadIndex() {
+	static auto Counter = std::atomic<int>(0);
+	thread_local const auto result = ++Counter;
+	return result;
+}
+
+void Push(Event &&event) {
+	QMutexLocker lock(&Mutex);
+	Events.push_back(std::move(event));
+}
+
+[[nodiscard]] QJsonObject Serialize(const Event &event) {
+	auto result = QJsonObject{
+		{ "name", QString::fromLatin1(event.name) },
+		{ "ts", double(event.start) },
+		{ "pid", 1 },
+		{ "tid", event.thread },
+	};
+	if (event.duration >= 0) {
+		result.insert("ph", "X");
+		result.insert("dur", double(event.duration));
+	} else {
+		result.insert("ph", "i");
+		result.insert("s", "g");
+	}
+	return result;
+}
+
+void CheckFinish() {
+	{
+		QMutexLocker lock(&Mutex);
+		if (Dumped) {
+			return;
+		}
+		for (const auto name : kFinishAfter) {
+			if (!MarkedFirst.contains(QByteArray(name))) {
+				return;
+			}
+		}
+	}
+
+	// Let the spans that are still open on the main thread end.
+	crl::on_main([] {
+		Finish("StartupTrace::finished");
+	});
+}
+
+} // namespace
+
+void Start(const QString &path) {
+	if (Started || path.isEmpty()) {
+		return;
+	}
+	StartTime = std::chrono::steady_clock::now();
+	Path = path;
+	ThreadIndex(); // Main thread gets the first index.
+	Started = true;
+}
+
+bool Enabled() {
+	return Started;
+}
+
+void Mark(const char *name) {
+	if (!Started) {
+		return;
+	}
+	Push({ .name = name, .start = Now(), .thread = ThreadIndex() });
+}
+
+void MarkFirst(const char *name) {
+	if (!Started) {
+		return;
+	}
+	{
+		QMutexLocker lock(&Mutex);
+		if (!MarkedFirst.emplace(QByteArray(name)).second) {
+			return;
+		}
+	}
+	Mark(name);
+	if (!qstrcmp(name, kFinishAfter.front())) {
+		base::call_delayed(kFinishTimeout, [] {
+			Finish("StartupTrace::timeout");
+		});
+	}
+	CheckFinish();
+}
+
+void Finish(const char *name) {
+	if (!Started) {
+		return;
+	}
+	{
+		QMutexLocker lock(&Mutex);
+		if (Dumped) {
+			return;
+		}
+	}
+	Mark(name);
+	Dump();
+	Quit();
+}
+
+void Dump() {
+	if (!Started) {
+		return;
+	}
+	auto events = QJsonArray();
+	{
+		QMutexLocker lock(&Mutex);
+		if (Dumped) {
+			return;
+		}
+		Dumped = true;
+		for (const auto &event : Events) {
+			events.push_back(Serialize(event));
+		}
+	}
+	const auto document = QJsonDocument(QJsonObject{
+		{ "traceEvents", events },
+		{ "displayTimeUnit", "ms" },
+	});
+	QFile f(Path);
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG(("Startup Trace Error: Could not write '%1'.").arg(Path));
+		return;
+	}
+	f.write(document.toJson(QJsonDocument::Compact));
+	LOG(("Startup Trace: Written %1 events to '%2'."
+		).arg(events.size()
+		).arg(Path));
+}
+
+Span::Span(const char *name)
+: _name(name)
+, _start(Started ? Now() : -1) {
+}
+
+Span::~Span() {
+	if (_start < 0 || !Started) {
+		return;
+	}
+	Push({
+		.name = _name,
+		.start = _start,
+		.duration = Now() - _start,
+		.thread = ThreadIndex(),
+	});
+}
+
+} // namespace Core::StartupTrace
@@ -0,0 +1,43 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+// Opt-in launch timeline in Chrome trace JSON format (chrome://tracing).
+// Enabled by the "-tracestartup <path>" command line argument, the trace
+// is written to <path> and the app quits when the chats list is shown
+// and the first difference is received. Opening a chat before that is
+// recorded as well, but is not required to finish.
+namespace Core::StartupTrace {
+
+void Start(const QString &path);
+[[nodiscard]] bool Enabled();
+
+void Mark(const char *name);
+
+// Only the first mark with this name is recorded.
+// The trace is finished when all the final milestones are marked.
+void MarkFirst(const char *name);
+
+// Marks the last milestone, writes the trace and quits.
+void Finish(const char *name);
+void Dump();
+
+class Span final {
+public:
+	explicit Span(const char *name);
+	Span(const Span &other) = delete;
+	Span &operator=(const Span &other) = delete;
+	~Span();
+
+private:
+	const char *_name = nullptr;
+	int64 _start = -1;
+
+};
+
+} // namespace Core::StartupTrace
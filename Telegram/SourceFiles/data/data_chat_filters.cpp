@@ -409,6 +409,7 @@ not_null<Dialogs::MainList*> ChatFilters::chatsList(FilterId filterId) {
 void ChatFilters::clear() {
 	_chatsLists.clear();
 	_list.clear();
+	_membership.clear();
 }
 
 void ChatFilters::setPreloaded(
@@ -479,6 +480,7 @@ void ChatFilters::requestToggleTags(bool value, Fn<void()> fail) {
 }
 
 void ChatFilters::received(const QVector<MTPDialogFilter> &list) {
+	_membership.clear();
 	auto position = 0;
 	auto changed = false;
 	for (const auto &filter : list) {
@@ -681,6 +683,7 @@ void ChatFilters::moveAllToFront() {
 		_list.erase(i);
 	}
 	_list.insert(begin(_list), ChatFilter());
+	_membership.clear();
 }
 
 void ChatFilters::applyRemove(int position) {
@@ -689,11 +692,14 @@ void ChatFilters::applyRemove(int position) {
 	const auto i = begin(_list) + position;
 	applyChange(*i, ChatFilter(i->id(), {}, {}, {}, {}, {}, {}, {}));
 	_list.erase(i);
+	_membership.clear();
 }
 
 bool ChatFilters::applyChange(ChatFilter &filter, ChatFilter &&updated) {
 	Expects(filter.id() == updated.id());
 
+	_membership.clear();
+
 	using Flag = ChatFilter::Flag;
 
 	const auto id = filter.id();
@@ -813,6 +819,7 @@ bool ChatFilters::applyOrder(const QVector<MTPint> &order) {
 		++begin;
 	}
 	if (changed) {
+		_membership.clear();
 		_listChanged.fire({});
 	}
 	return true;
@@ -974,11 +981,32 @@ bool ChatFilters::loadNextExceptions(bool chatsListLoaded) {
 }
 
 void ChatFilters::refreshHistory(not_null<History*> history) {
+	_membership.erase(history);
 	if (history->inChatList() && !list().empty()) {
 		_owner->refreshChatListEntry(history);
 	}
 }
 
+void ChatFilters::forgetMembership(not_null<History*> history) {
+	_membership.erase(history);
+}
+
+uint64 ChatFilters::membership(not_null<History*> history) {
+	const auto known = _membership.find(history);
+	if (known != end(_membership)) {
+		return known->second;
+	}
+	auto mask = uint64();
+	const auto count = std::min(int(_list.size()), kMembershipBits);
+	for (auto i = 0; i != count; ++i) {
+		if (_list[i].contains(history)) {
+			mask |= (uint64(1) << i);
+		}
+	}
+	_membership.emplace(history, mask);
+	return mask;
+}
+
 void ChatFilters::requestSuggested() {
 	if (_suggestedRequestId) {
 		return;
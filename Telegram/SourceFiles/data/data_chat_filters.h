@@ -175,6 +175,13 @@ public:
 
 	void refreshHistory(not_null<History*> history);
 
+	// Bit i is set if list()[i] contains the history. It is cached until
+	// the filters change, refreshHistory() is called for this history or
+	// the history leaves the chats list.
+	static constexpr auto kMembershipBits = 64;
+	[[nodiscard]] uint64 membership(not_null<History*> history);
+	void forgetMembership(not_null<History*> history);
+
 	[[nodiscard]] not_null<Dialogs::MainList*> chatsList(FilterId filterId);
 	void clear();
 
@@ -265,6 +272,8 @@ private:
 	rpl::event_stream<FilterId> _moreChatsUpdated;
 	base::Timer _moreChatsTimer;
 
+	std::unordered_map<not_null<History*>, uint64> _membership;
+
 };
 
 [[nodiscard]] bool CanRemoveFromChatFilter(
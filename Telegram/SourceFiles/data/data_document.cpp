@@ -26,6 +26,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/streaming/media_streaming_loader_local.h"
 #include "storage/localstorage.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_write_back.h"
 #include "storage/streamed_file_downloader.h"
 #include "storage/file_download_mtproto.h"
 #include "storage/file_download_web.h"
@@ -1871,6 +1872,8 @@ void DocumentData::collectLocalData(not_null<DocumentData*> local) {
 		return;
 	}
 
+	_owner->cacheWriteBack().flush(local->cacheKey());
+	_owner->cacheWriteBack().flush(cacheKey());
 	_owner->cache().copyIfEmpty(local->cacheKey(), cacheKey());
 	if (const auto localMedia = local->activeMediaView()) {
 		auto media = createMediaView();
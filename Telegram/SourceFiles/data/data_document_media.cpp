@@ -24,6 +24,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/mime_type.h"
 #include "storage/file_download.h"
+#include "storage/storage_cache_write_back.h"
 #include "ui/chat/attach/attach_prepare.h"
 
 #include <QtCore/QBuffer>
@@ -506,7 +507,9 @@ void DocumentMedia::ReadOrGenerateThumbnail(
 			});
 		}
 	};
-	document->owner().cache().get(document->goodThumbnailCacheKey(), got);
+	const auto key = document->goodThumbnailCacheKey();
+	document->owner().cacheWriteBack().flush(key);
+	document->owner().cache().get(key, got);
 }
 
 auto DocumentIconFrameGenerator(not_null<DocumentMedia*> media)
@@ -243,8 +243,25 @@ const GroupCallParticipant *GroupCall::participantByPeer(
 
 GroupCallParticipant *GroupCall::findParticipant(
 		not_null<PeerData*> peer) {
-	const auto i = ranges::find(_participants, peer, &Participant::peer);
-	return (i != end(_participants)) ? &*i : nullptr;
+	const auto i = _participantIndexByPeer.find(peer);
+	return (i != end(_participantIndexByPeer))
+		? &_participants[i->second]
+		: nullptr;
+}
+
+void GroupCall::eraseParticipant(not_null<PeerData*> peer) {
+	const auto i = _participantIndexByPeer.find(peer);
+	Assert(i != end(_participantIndexByPeer));
+
+	// Order doesn't matter, members list sorts its rows by itself.
+	const auto index = i->second;
+	const auto last = int(_participants.size()) - 1;
+	_participantIndexByPeer.erase(i);
+	if (index != last) {
+		_participants[index] = std::move(_participants[last]);
+		_participantIndexByPeer[_participants[index].peer] = index;
+	}
+	_participants.pop_back();
 }
 
 const GroupCallParticipant *GroupCall::participantByEndpoint(
@@ -370,6 +387,7 @@ void GroupCall::processFullCallFields(const MTPphone_GroupCall &call) {
 		const auto nextOffset = qs(data.vparticipants_next_offset());
 		data.vcall().match([&](const MTPDgroupCall &data) {
 			_participants.clear();
+			_participantIndexByPeer.clear();
 			_speakingByActiveFinishes.clear();
 			_participantPeerByAudioSsrc.clear();
 			_allParticipantsLoaded = false;
@@ -563,17 +581,19 @@ bool GroupCall::requestParticipantsAfterReload(
 void GroupCall::applyParticipantsSlice(
 		const QVector<MTPGroupCallParticipant> &list,
 		ApplySliceSource sliceSource) {
+	if (sliceSource != ApplySliceSource::UpdateReceived) {
+		const auto size = int(_participants.size() + list.size());
+		_participants.reserve(size);
+		_participantIndexByPeer.reserve(size);
+	}
 	for (const auto &participant : list) {
 		participant.match([&](const MTPDgroupCallParticipant &data) {
 			const auto participantPeerId = peerFromMTP(data.vpeer());
 			const auto participantPeer = _peer->owner().peer(
 				participantPeerId);
-			const auto i = ranges::find(
-				_participants,
-				participantPeer,
-				&Participant::peer);
+			const auto i = findParticipant(participantPeer);
 			if (data.is_left()) {
-				if (i != end(_participants)) {
+				if (i) {
 					auto update = ParticipantUpdate{
 						.was = *i,
 					};
@@ -581,7 +601,7 @@ void GroupCall::applyParticipantsSlice(
 					_participantPeerByAudioSsrc.erase(
 						GetAdditionalAudioSsrc(i->videoParams));
 					_speakingByActiveFinishes.remove(participantPeer);
-					_participants.erase(i);
+					eraseParticipant(participantPeer);
 					if (sliceSource != ApplySliceSource::FullReloaded) {
 						_participantUpdates.fire(std::move(update));
 					}
@@ -594,7 +614,7 @@ void GroupCall::applyParticipantsSlice(
 			if (const auto about = data.vabout()) {
 				participantPeer->setAbout(qs(*about));
 			}
-			const auto was = (i != end(_participants))
+			const auto was = i
 				? std::make_optional(*i)
 				: std::nullopt;
 			const auto canSelfUnmute = !data.is_muted()
@@ -619,7 +639,7 @@ void GroupCall::applyParticipantsSlice(
 				= data.vraise_hand_rating().value_or_empty();
 			const auto localUpdate = (sliceSource
 				== ApplySliceSource::UpdateConstructed);
-			const auto existingVideoParams = (i != end(_participants))
+			const auto existingVideoParams = i
 				? i->videoParams
 				: nullptr;
 			auto videoParams = localUpdate
@@ -651,7 +671,7 @@ void GroupCall::applyParticipantsSlice(
 				.videoJoined = videoJoined,
 				.applyVolumeFromMin = applyVolumeFromMin,
 			};
-			if (i == end(_participants)) {
+			if (!i) {
 				if (value.ssrc) {
 					_participantPeerByAudioSsrc.emplace(
 						value.ssrc,
@@ -663,6 +683,9 @@ void GroupCall::applyParticipantsSlice(
 						additional,
 						participantPeer);
 				}
+				_participantIndexByPeer.emplace(
+					participantPeer,
+					int(_participants.size()));
 				_participants.push_back(value);
 				if (const auto user = participantPeer->asUser()) {
 					_peer->owner().unregisterInvitedToCallUser(_id, user);
@@ -915,11 +938,7 @@ void GroupCall::requestUnknownParticipants() {
 		}
 		for (const auto &[id, when] : participantPeerIds) {
 			if (const auto participantPeer = _peer->owner().peerLoaded(id)) {
-				const auto isParticipant = ranges::contains(
-					_participants,
-					not_null{ participantPeer },
-					&Participant::peer);
-				if (isParticipant) {
+				if (findParticipant(participantPeer)) {
 					applyActiveUpdate(id, when, participantPeer);
 				}
 			}
@@ -199,6 +199,7 @@ private:
 	[[nodiscard]] bool processSavedFullCall();
 	void finishParticipantsSliceRequest();
 	[[nodiscard]] Participant *findParticipant(not_null<PeerData*> peer);
+	void eraseParticipant(not_null<PeerData*> peer);
 
 	const CallId _id = 0;
 	const CallId _accessHash = 0;
@@ -217,6 +218,7 @@ private:
 	std::optional<MTPphone_GroupCall> _savedFull;
 
 	std::vector<Participant> _participants;
+	std::unordered_map<not_null<PeerData*>, int> _participantIndexByPeer;
 	base::flat_map<uint32, not_null<PeerData*>> _participantPeerByAudioSsrc;
 	base::flat_map<not_null<PeerData*>, crl::time> _speakingByActiveFinishes;
 	base::Timer _speakingByActiveFinishTimer;
@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_forum.h"
 #include "data/data_forum_topic.h"
 #include "data/data_user.h"
+#include "dialogs/dialogs_main_list.h"
 #include "base/unixtime.h"
 #include "base/random.h"
 #include "main/main_session.h"
@@ -24,8 +25,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 #include "history/history_item.h"
 #include "history/history_item_helpers.h"
+#include "history/history_unread_things.h"
 #include "history/view/history_view_element.h"
 #include "core/application.h"
+#include "mtproto/mtp_instance.h"
+#include "mtproto/facade.h"
 #include "apiwrap.h"
 
 namespace Data {
@@ -33,6 +37,14 @@ namespace {
 
 constexpr auto kReadRequestTimeout = 3 * crl::time(1000);
 constexpr auto kReportDeliveriesPerRequest = 50;
+constexpr auto kPreloadDelay = 2 * crl::time(1000);
+constexpr auto kPreloadRetryDelay = 10 * crl::time(1000);
+constexpr auto kPreloadNextDelay = crl::time(300);
+constexpr auto kPreloadScanRows = 20;
+constexpr auto kPreloadTopChats = 5;
+constexpr auto kPreloadMessagesCount = 30;
+constexpr auto kPreloadBudget = 20;
+constexpr auto kPreloadBudgetPeriod = 10 * 60 * crl::time(1000);
 
 } // namespace
 
@@ -102,7 +114,8 @@ MTPInputMedia WebPageForMTP(
 
 Histories::Histories(not_null<Session*> owner)
 : _owner(owner)
-, _readRequestsTimer([=] { sendReadRequests(); }) {
+, _readRequestsTimer([=] { sendReadRequests(); })
+, _preloadTimer([=] { preloadNext(); }) {
 }
 
 Session &Histories::owner() const {
@@ -137,6 +150,9 @@ void Histories::unloadAll() {
 }
 
 void Histories::clearAll() {
+	_preloadTimer.cancel();
+	cancelRequest(base::take(_preloadRequestId));
+	_preloaded.clear();
 	_map.clear();
 }
 
@@ -445,6 +461,7 @@ void Histories::dialogEntryApplied(not_null<History*> history) {
 		history->setInboxReadTill(base::take(state->sentReadTill));
 		checkEmptyState(history);
 	}
+	schedulePreload();
 }
 
 void Histories::applyPeerDialogs(const MTPmessages_PeerDialogs &dialogs) {
@@ -555,6 +572,167 @@ void Histories::requestGroupAround(not_null<HistoryItem*> item) {
 		ChatListGroupRequest{ .aroundId = id, .requestId = requestId });
 }
 
+void Histories::schedulePreload() {
+	if (!_preloadRequestId && !_preloadTimer.isActive()) {
+		_preloadTimer.callOnce(kPreloadDelay);
+	}
+}
+
+void Histories::preloadNext() {
+	if (_preloadRequestId || !_owner->chatsList()->loaded()) {
+		return;
+	}
+	const auto now = crl::now();
+	if (!_preloadBudgetStart
+		|| now - _preloadBudgetStart >= kPreloadBudgetPeriod) {
+		_preloadBudgetStart = now;
+		_preloadBudgetUsed = 0;
+	}
+	if (_preloadBudgetUsed >= kPreloadBudget) {
+		_preloadTimer.callOnce(
+			_preloadBudgetStart + kPreloadBudgetPeriod - now);
+		return;
+	} else if (preloadBusy()) {
+		_preloadTimer.callOnce(kPreloadRetryDelay);
+		return;
+	}
+	const auto candidates = preloadCandidates();
+	const auto i = ranges::find_if(candidates, [&](not_null<History*> h) {
+		return preloadAllowed(h);
+	});
+	if (i != end(candidates)) {
+		preloadHistory(*i);
+	}
+}
+
+bool Histories::preloadBusy() const {
+	// Metered connections are not reported by Qt in a portable way,
+	// so only the connection state and foreground requests are checked.
+	if (session().mtp().dcstate() != MTP::ConnectedState) {
+		return true;
+	}
+	for (const auto &[history, state] : _states) {
+		if (!state.postponed.empty()) {
+			return true;
+		}
+		for (const auto &[id, sent] : state.sent) {
+			if (sent.type == RequestType::History) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool Histories::preloadAllowed(not_null<History*> history) const {
+	// Migrated and forum histories are prepared by their own widgets.
+	return history->isEmpty()
+		&& !history->isForum()
+		&& !history->peer->migrateFrom()
+		&& !_preloaded.contains(history)
+		&& !_states.contains(history);
+}
+
+std::vector<not_null<History*>> Histories::preloadCandidates() const {
+	struct Ranked {
+		not_null<History*> history;
+		int rank = 0;
+	};
+	auto ranked = std::vector<Ranked>();
+	ranked.reserve(kPreloadScanRows);
+
+	// Rows are already ordered by pinned state and the last message date.
+	for (const auto &row : *_owner->chatsList()->indexed()) {
+		if (ranked.size() == kPreloadScanRows) {
+			break;
+		} else if (const auto history = row->history()) {
+			const auto rank = history->unreadMentions().has()
+				? 0
+				: (history->unreadCount() > 0 || history->unreadMark())
+				? 1
+				: history->isPinnedDialog(FilterId())
+				? 2
+				: 3;
+			ranked.push_back({ history, rank });
+		}
+	}
+	ranges::stable_sort(ranked, ranges::less(), &Ranked::rank);
+
+	auto result = std::vector<not_null<History*>>();
+	const auto count = std::min(int(ranked.size()), kPreloadTopChats);
+	result.reserve(count);
+	for (auto i = 0; i != count; ++i) {
+		result.push_back(ranked[i].history);
+	}
+	return result;
+}
+
+void Histories::preloadHistory(not_null<History*> history) {
+	const auto around = history->loadAroundId();
+	const auto offset = around ? (-kPreloadMessagesCount / 2) : 0;
+
+	_preloaded.emplace(history);
+	++_preloadBudgetUsed;
+	_preloadRequestId = sendRequest(history, RequestType::History, [=](
+			Fn<void()> finish) {
+		return session().api().request(MTPmessages_GetHistory(
+			history->peer->input,
+			MTP_int(around),
+			MTP_int(0), // offset_date
+			MTP_int(offset),
+			MTP_int(kPreloadMessagesCount),
+			MTP_int(0), // max_id
+			MTP_int(0), // min_id
+			MTP_long(0) // hash
+		)).done([=](const MTPmessages_Messages &result) {
+			_preloadRequestId = 0;
+			preloadApply(history, around, result);
+			finish();
+			_preloadTimer.callOnce(kPreloadNextDelay);
+		}).fail([=] {
+			_preloadRequestId = 0;
+			finish();
+			_preloadTimer.callOnce(kPreloadRetryDelay);
+		}).send();
+	});
+}
+
+void Histories::preloadApply(
+		not_null<History*> history,
+		MsgId around,
+		const MTPmessages_Messages &result) {
+	const auto messages = result.match([&](
+			const MTPDmessages_messagesNotModified &) {
+		LOG(("API Error: received messages.messagesNotModified! "
+			"(Histories::preloadApply)"));
+		return QVector<MTPMessage>();
+	}, [&](const auto &data) {
+		if constexpr (MTPDmessages_channelMessages::Is<decltype(data)>()) {
+			if (const auto channel = history->peer->asChannel()) {
+				channel->ptsReceived(data.vpts().v);
+				channel->processTopics(data.vtopics());
+			}
+		}
+		_owner->processUsers(data.vusers());
+		_owner->processChats(data.vchats());
+		return data.vmessages().v;
+	});
+
+	// The chat could be opened or read while the request was in flight.
+	if (messages.isEmpty()
+		|| !history->isEmpty()
+		|| history->loadAroundId() != around) {
+		return;
+	}
+	const auto showAt = around ? ShowAtUnreadMsgId : ShowAtTheEndMsgId;
+	history->getReadyFor(showAt);
+	history->addOlderSlice(messages);
+	DEBUG_LOG(("History Preload: %1 messages for %2, ready: %3."
+		).arg(messages.size()
+		).arg(history->peer->id.value
+		).arg(Logs::b(history->isReadyFor(showAt))));
+}
+
 void Histories::sendPendingReadInbox(not_null<History*> history) {
 	if (const auto state = lookup(history)) {
 		DEBUG_LOG(("Reading: send pending now with till %1 and when %2"
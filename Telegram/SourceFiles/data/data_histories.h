@@ -75,6 +75,9 @@ public:
 
 	void requestGroupAround(not_null<HistoryItem*> item);
 
+	// Idle loading of the first slice for chats likely to be opened next.
+	void schedulePreload();
+
 	void deleteMessages(
 		not_null<History*> history,
 		const QVector<MTPint> &ids,
@@ -204,6 +207,16 @@ private:
 	void sendDialogRequests();
 	void reportPendingDeliveries();
 
+	void preloadNext();
+	[[nodiscard]] bool preloadBusy() const;
+	[[nodiscard]] bool preloadAllowed(not_null<History*> history) const;
+	[[nodiscard]] std::vector<not_null<History*>> preloadCandidates() const;
+	void preloadHistory(not_null<History*> history);
+	void preloadApply(
+		not_null<History*> history,
+		MsgId around,
+		const MTPmessages_Messages &result);
+
 	[[nodiscard]] bool isCreatingTopic(
 		not_null<History*> history,
 		MsgId rootId) const;
@@ -243,6 +256,12 @@ private:
 		base::flat_set<MsgId>> _pendingDeliveryReport;
 	base::flat_set<not_null<PeerData*>> _deliveryReportSent;
 
+	base::Timer _preloadTimer;
+	base::flat_set<not_null<History*>> _preloaded;
+	int _preloadRequestId = 0;
+	int _preloadBudgetUsed = 0;
+	crl::time _preloadBudgetStart = 0;
+
 };
 
 } // namespace Data
@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session_settings.h"
 #include "media/streaming/media_streaming_reader.h"
 #include "storage/file_download.h" // kMaxFileInMemory.
+#include "storage/storage_cache_write_back.h"
 
 namespace Data {
 namespace {
@@ -100,6 +101,7 @@ VideoPreload::VideoPreload(
 void VideoPreload::check() {
 	const auto key = _video->bigFileBaseCacheKey();
 	const auto weak = base::make_weak(static_cast<has_weak_ptr*>(this));
+	_video->owner().cacheBigFileWriteBack().flush(key);
 	_video->owner().cacheBigFile().get(key, [weak](
 			const QByteArray &result) {
 		if (!result.isEmpty()) {
@@ -123,6 +125,14 @@ void VideoPreload::load() {
 		callDone();
 		return;
 	}
+	auto &writeBack = _video->owner().cacheBigFileWriteBack();
+	if (writeBack.overloaded()) {
+		// Don't download more while the cache writes are behind.
+		writeBack.drained() | rpl::take(1) | rpl::start_with_next([=] {
+			load();
+		}, _lifetime);
+		return;
+	}
 	const auto prefix = ChoosePreloadPrefix(_video);
 	Assert(prefix > 0 && prefix <= _video->size);
 	const auto part = Storage::kDownloadPartSize;
@@ -137,7 +147,7 @@ void VideoPreload::done(QByteArray result) {
 	const auto key = _video->bigFileBaseCacheKey();
 	if (!result.isEmpty() && key) {
 		Assert(result.size() < Storage::kMaxFileInMemory);
-		_video->owner().cacheBigFile().putIfEmpty(
+		_video->owner().cacheBigFileWriteBack().putIfEmpty(
 			key,
 			Storage::Cache::Database::TaggedValue(std::move(result), 0));
 	}
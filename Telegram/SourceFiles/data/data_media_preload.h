@@ -77,6 +77,7 @@ private:
 	int _nextRequestOffset = 0;
 	bool _finished = false;
 	bool _failed = false;
+	rpl::lifetime _lifetime;
 
 };
 
@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/streaming/media_streaming_loader_local.h"
 #include "media/streaming/media_streaming_loader_mtproto.h"
 #include "storage/file_download.h"
+#include "storage/storage_cache_write_back.h"
 #include "core/application.h"
 
 namespace {
@@ -300,6 +301,8 @@ void PhotoData::collectLocalData(not_null<PhotoData*> local) {
 	for (auto i = 0; i != kPhotoSizeCount; ++i) {
 		if (const auto from = local->_images[i].location.file().cacheKey()) {
 			if (const auto to = _images[i].location.file().cacheKey()) {
+				_owner->cacheWriteBack().flush(from);
+				_owner->cacheWriteBack().flush(to);
 				_owner->cache().copyIfEmpty(from, to);
 			}
 		}
@@ -32,6 +32,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/history_view_element.h"
 #include "inline_bots/inline_bot_layout_item.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_write_back.h"
 #include "storage/storage_encrypted_file.h"
 #include "media/player/media_player_instance.h" // instance()->play()
 #include "media/audio/media_audio.h"
@@ -86,6 +87,9 @@ namespace {
 
 using ViewElement = HistoryView::Element;
 
+// Long texts keep parsed layouts only for the last used views.
+constexpr auto kEvictableTextsLimit = 200;
+
 // s: box 100x100
 // m: box 320x320
 // x: box 800x800
@@ -219,6 +223,10 @@ Session::Session(not_null<Main::Session*> session)
 , _bigFileCache(Core::App().databases().get(
 	_session->local().cacheBigFilePath(),
 	_session->local().cacheBigFileSettings()))
+, _cacheWriteBack(
+	std::make_unique<Storage::CacheWriteBack>(_cache.get()))
+, _bigFileCacheWriteBack(
+	std::make_unique<Storage::CacheWriteBack>(_bigFileCache.get()))
 , _groupFreeTranscribeLevel(session->appConfig().value(
 ) | rpl::map([limits = Data::LevelLimits(session)] {
 	return limits.groupTranscribeLevelMin();
@@ -407,6 +415,7 @@ void Session::clear() {
 		folder->clearChatsList();
 	}
 	_chatsFilters->clear();
+	_chatListFiltersRefreshes.clear();
 	_histories->clearAll();
 	_webpages.clear();
 	_locations.clear();
@@ -1207,11 +1216,7 @@ void Session::registerInvitedToCallUser(
 		not_null<UserData*> user) {
 	const auto call = peer->groupCall();
 	if (call && call->id() == callId) {
-		const auto inCall = ranges::contains(
-			call->participants(),
-			user,
-			&Data::GroupCallParticipant::peer);
-		if (inCall) {
+		if (call->participantByPeer(user)) {
 			return;
 		}
 	}
@@ -1343,6 +1348,7 @@ void Session::chatsListDone(Data::Folder *folder) {
 		folder->chatsList()->setLoaded();
 	} else {
 		_chatsList.setLoaded();
+		_histories->schedulePreload();
 	}
 	_chatsListLoadedEvents.fire_copy(folder);
 }
@@ -1374,6 +1380,14 @@ Storage::Cache::Database &Session::cacheBigFile() {
 	return *_bigFileCache;
 }
 
+Storage::CacheWriteBack &Session::cacheWriteBack() {
+	return *_cacheWriteBack;
+}
+
+Storage::CacheWriteBack &Session::cacheBigFileWriteBack() {
+	return *_bigFileCacheWriteBack;
+}
+
 void Session::suggestStartExport(TimeId availableAt) {
 	_exportAvailableAt = availableAt;
 	suggestStartExport();
@@ -1501,6 +1515,10 @@ void Session::setupUserIsContactViewer() {
 				requestViewResize(view);
 			}
 		}
+		if (const auto history = historyLoaded(user)) {
+			// Contacts and non-contacts are in different filters.
+			chatsFilters().refreshHistory(history);
+		}
 		if (!user->isLoaded()) {
 			LOG(("API Error: "
 				"userIsContactChanged() called for a not loaded user!"));
@@ -2001,6 +2019,34 @@ void Session::unregisterHeavyViewPart(not_null<ViewElement*> view) {
 	_heavyViewParts.remove(view);
 }
 
+void Session::touchEvictableText(not_null<ViewElement*> view) {
+	const auto i = _evictableTextPositions.find(view);
+	if (i != end(_evictableTextPositions)) {
+		_evictableTexts.splice(
+			end(_evictableTexts),
+			_evictableTexts,
+			i->second);
+		return;
+	}
+	_evictableTextPositions.emplace(
+		view,
+		_evictableTexts.insert(end(_evictableTexts), view));
+	while (int(_evictableTexts.size()) > kEvictableTextsLimit) {
+		const auto evict = _evictableTexts.front();
+		_evictableTexts.pop_front();
+		_evictableTextPositions.erase(evict);
+		evict->evictText();
+	}
+}
+
+void Session::unregisterEvictableText(not_null<ViewElement*> view) {
+	const auto i = _evictableTextPositions.find(view);
+	if (i != end(_evictableTextPositions)) {
+		_evictableTexts.erase(i->second);
+		_evictableTextPositions.erase(i);
+	}
+}
+
 void Session::unloadHeavyViewParts(
 		not_null<HistoryView::ElementDelegate*> delegate) {
 	if (_heavyViewParts.empty()) {
@@ -2410,7 +2456,10 @@ void Session::updateEditedMessage(const MTPMessage &data) {
 void Session::processMessages(
 		const QVector<MTPMessage> &data,
 		NewMessageType type) {
-	auto indices = base::flat_map<uint64, int>();
+	// Sorted once after filling, inserting in a flat_map one by one
+	// is quadratic in the size of the slice.
+	auto indices = std::vector<std::pair<uint64, int>>();
+	indices.reserve(data.size());
 	for (int i = 0, l = data.size(); i != l; ++i) {
 		const auto &message = data[i];
 		if (message.type() == mtpc_message) {
@@ -2422,8 +2471,9 @@ void Session::processMessages(
 			}
 		}
 		const auto id = IdFromMessage(message); // Only 32 bit values here.
-		indices.emplace((uint64(uint32(id.bare)) << 32) | uint64(i), i);
+		indices.emplace_back((uint64(uint32(id.bare)) << 32) | uint64(i), i);
 	}
+	ranges::sort(indices);
 	for (const auto &[position, index] : indices) {
 		addNewMessage(
 			data[index],
@@ -3277,8 +3327,14 @@ void Session::documentConvert(
 	}
 	documentApplyFields(original, data);
 	if (idChanged) {
-		cache().moveIfEmpty(oldCacheKey, original->cacheKey());
-		cache().moveIfEmpty(oldGoodKey, original->goodThumbnailCacheKey());
+		const auto newCacheKey = original->cacheKey();
+		const auto newGoodKey = original->goodThumbnailCacheKey();
+		cacheWriteBack().flush(oldCacheKey);
+		cacheWriteBack().flush(newCacheKey);
+		cacheWriteBack().flush(oldGoodKey);
+		cacheWriteBack().flush(newGoodKey);
+		cache().moveIfEmpty(oldCacheKey, newCacheKey);
+		cache().moveIfEmpty(oldGoodKey, newGoodKey);
 		if (stickers().savedGifs().indexOf(original) >= 0) {
 			_session->local().writeSavedGifs();
 		}
@@ -4428,6 +4484,7 @@ void Session::registerItemView(not_null<ViewElement*> view) {
 
 void Session::unregisterItemView(not_null<ViewElement*> view) {
 	Expects(!_heavyViewParts.contains(view));
+	Expects(!_evictableTextPositions.contains(view));
 
 	_shownSpoilers.remove(view);
 
@@ -4534,40 +4591,69 @@ void Session::refreshChatListEntry(Dialogs::Key key) {
 	}
 	if (!history) {
 		return;
+	} else if (!creating) {
+		scheduleChatListFiltersRefresh(history);
+		return;
 	}
-	for (const auto &filter : _chatsFilters->list()) {
+	_chatListFiltersRefreshes.remove(history);
+	_chatsFilters->forgetMembership(history);
+	refreshChatListFilters(history);
+
+	if (const auto from = history->peer->migrateFrom()) {
+		if (const auto migrated = historyLoaded(from)) {
+			removeChatListEntry(migrated);
+		}
+	}
+	if (const auto forum = history->peer->forum()) {
+		forum->preloadTopics();
+	}
+}
+
+void Session::scheduleChatListFiltersRefresh(not_null<History*> history) {
+	if (_chatsFilters->list().empty()) {
+		return;
+	} else if (_chatListFiltersRefreshes.empty()) {
+		// Many updates of the same chat in one tick move it only once.
+		crl::on_main(_session, [=] {
+			for (const auto &pending : base::take(_chatListFiltersRefreshes)) {
+				if (pending->inChatList()) {
+					refreshChatListFilters(pending);
+				}
+			}
+		});
+	}
+	_chatListFiltersRefreshes.emplace(history);
+}
+
+void Session::refreshChatListFilters(not_null<History*> history) {
+	const auto &list = _chatsFilters->list();
+	const auto membership = _chatsFilters->membership(history);
+	for (auto i = 0, count = int(list.size()); i != count; ++i) {
+		const auto &filter = list[i];
 		const auto id = filter.id();
 		if (!id) {
 			continue;
 		}
+		const auto contains = (i < ChatFilters::kMembershipBits)
+			? ((membership >> i) & 1)
+			: filter.contains(history);
 		const auto filterList = chatsFilters().chatsList(id);
-		auto event = ChatListEntryRefresh{ .key = key, .filterId = id };
-		if (filter.contains(history)) {
-			event.existenceChanged = !entry->inChatList(id);
+		auto event = ChatListEntryRefresh{ .key = history, .filterId = id };
+		if (contains) {
+			event.existenceChanged = !history->inChatList(id);
 			if (event.existenceChanged) {
-				entry->addToChatList(id, filterList);
+				history->addToChatList(id, filterList);
 			} else {
-				event.moved = entry->adjustByPosInChatList(id, filterList);
+				event.moved = history->adjustByPosInChatList(id, filterList);
 			}
-		} else if (entry->inChatList(id)) {
-			entry->removeFromChatList(id, filterList);
+		} else if (history->inChatList(id)) {
+			history->removeFromChatList(id, filterList);
 			event.existenceChanged = true;
 		}
 		if (event) {
 			_chatListEntryRefreshes.fire(std::move(event));
 		}
 	}
-
-	if (creating) {
-		if (const auto from = history->peer->migrateFrom()) {
-			if (const auto migrated = historyLoaded(from)) {
-				removeChatListEntry(migrated);
-			}
-		}
-		if (const auto forum = history->peer->forum()) {
-			forum->preloadTopics();
-		}
-	}
 }
 
 void Session::removeChatListEntry(Dialogs::Key key) {
@@ -4592,6 +4678,10 @@ void Session::removeChatListEntry(Dialogs::Key key) {
 	}
 	const auto mainList = chatsListFor(entry);
 	entry->removeFromChatList(0, mainList);
+	if (const auto history = entry->asHistory()) {
+		_chatListFiltersRefreshes.remove(history);
+		_chatsFilters->forgetMembership(history);
+	}
 	_chatListEntryRefreshes.fire(ChatListEntryRefresh{
 		.key = key,
 		.existenceChanged = true
@@ -4903,6 +4993,8 @@ rpl::producer<SentFromScheduled> Session::sentFromScheduled() const {
 }
 
 void Session::clearLocalStorage() {
+	_cacheWriteBack->clear();
+	_bigFileCacheWriteBack->clear();
 	_cache->close();
 	_cache->clear();
 	_bigFileCache->close();
@@ -15,6 +15,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_location_manager.h"
 #include "base/timer.h"
 
+#include <list>
+
 class Image;
 class HistoryItem;
 struct WebPageCollage;
@@ -44,6 +46,10 @@ namespace Iv {
 class Data;
 } // namespace Iv
 
+namespace Storage {
+class CacheWriteBack;
+} // namespace Storage
+
 namespace Data {
 
 class Folder;
@@ -201,6 +207,10 @@ public:
 	[[nodiscard]] Storage::Cache::Database &cache();
 	[[nodiscard]] Storage::Cache::Database &cacheBigFile();
 
+	// Preferred for puts of downloaded or generated content.
+	[[nodiscard]] Storage::CacheWriteBack &cacheWriteBack();
+	[[nodiscard]] Storage::CacheWriteBack &cacheBigFileWriteBack();
+
 	[[nodiscard]] not_null<PeerData*> peer(PeerId id);
 	[[nodiscard]] not_null<PeerData*> peer(UserId id) = delete;
 	[[nodiscard]] not_null<UserData*> user(UserId id);
@@ -359,6 +369,8 @@ public:
 
 	void registerHeavyViewPart(not_null<ViewElement*> view);
 	void unregisterHeavyViewPart(not_null<ViewElement*> view);
+	void touchEvictableText(not_null<ViewElement*> view);
+	void unregisterEvictableText(not_null<ViewElement*> view);
 	void unloadHeavyViewParts(
 		not_null<HistoryView::ElementDelegate*> delegate);
 	void unloadHeavyViewParts(
@@ -831,6 +843,9 @@ private:
 	void checkSelfDestructItems();
 	void checkLocalUsersWentOffline();
 
+	void scheduleChatListFiltersRefresh(not_null<History*> history);
+	void refreshChatListFilters(not_null<History*> history);
+
 	void scheduleNextTTLs();
 	void checkTTLs();
 
@@ -954,6 +969,8 @@ private:
 
 	Storage::DatabasePointer _cache;
 	Storage::DatabasePointer _bigFileCache;
+	const std::unique_ptr<Storage::CacheWriteBack> _cacheWriteBack;
+	const std::unique_ptr<Storage::CacheWriteBack> _bigFileCacheWriteBack;
 
 	TimeId _exportAvailableAt = 0;
 	QPointer<Ui::BoxContent> _exportSuggestion;
@@ -988,6 +1005,7 @@ private:
 	rpl::event_stream<MegagroupParticipant> _megagroupParticipantAdded;
 	rpl::event_stream<DialogsRowReplacement> _dialogsRowReplacements;
 	rpl::event_stream<ChatListEntryRefresh> _chatListEntryRefreshes;
+	base::flat_set<not_null<History*>> _chatListFiltersRefreshes;
 	rpl::event_stream<> _unreadBadgeChanges;
 	rpl::event_stream<RepliesReadTillUpdate> _repliesReadTillUpdates;
 	rpl::event_stream<SentToScheduled> _sentToScheduled;
@@ -1091,6 +1109,12 @@ private:
 
 	base::flat_set<not_null<ViewElement*>> _heavyViewParts;
 
+	// Long message texts with parsed layouts, least recently used first.
+	std::list<not_null<ViewElement*>> _evictableTexts;
+	std::unordered_map<
+		not_null<ViewElement*>,
+		std::list<not_null<ViewElement*>>::iterator> _evictableTextPositions;
+
 	base::flat_map<uint64, not_null<GroupCall*>> _groupCalls;
 	rpl::event_stream<InviteToCall> _invitesToCalls;
 	base::flat_map<
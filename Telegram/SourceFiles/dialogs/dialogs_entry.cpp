@@ -279,6 +279,9 @@ void Entry::notifyUnreadStateChange(const UnreadState &wasState) {
 						Data::PeerUpdate::Flag::Name);
 				}
 			}
+		} else if (!wasState.mentions != !nowState.mentions) {
+			// Muted chats with mentions are shown in "no muted" filters.
+			owner().chatsFilters().refreshHistory(history);
 		}
 	}
 	updateChatListEntryPostponed();
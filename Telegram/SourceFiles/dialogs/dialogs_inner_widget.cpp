@@ -17,11 +17,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_search_from_controllers.h"
 #include "dialogs/dialogs_search_tags.h"
 #include "history/view/history_view_context_menu.h"
+#include "history/view/history_view_send_action.h"
 #include "history/history.h"
 #include "history/history_item.h"
 #include "core/application.h"
 #include "core/click_handler_types.h"
 #include "core/shortcuts.h"
+#include "core/startup_trace.h"
 #include "core/ui_integration.h"
 #include "ui/widgets/buttons.h"
 #include "ui/widgets/popup_menu.h"
@@ -91,6 +93,10 @@ constexpr auto kHashtagResultsLimit = 5;
 constexpr auto kStartReorderThreshold = 30;
 constexpr auto kQueryPreviewLimit = 32;
 constexpr auto kPreviewPostsLimit = 3;
+constexpr auto kRowsCacheLimit = 64;
+#ifdef _DEBUG
+constexpr auto kRowsCacheStatsEach = 300;
+#endif // _DEBUG
 
 [[nodiscard]] InnerWidget::ChatsFilterTagsKey SerializeFilterTagsKey(
 		FilterId filterId,
@@ -221,6 +227,36 @@ constexpr auto kPreviewPostsLimit = 3;
 	Unexpected("Chat type filter in search results.");
 }
 
+// Same values that are used to paint the stories outline in Row.
+[[nodiscard]] std::pair<int, int> RowStoriesState(not_null<Row*> row) {
+	if (const auto folder = row->folder()) {
+		return { folder->storiesCount(), folder->storiesUnreadCount() };
+	}
+	const auto history = row->history();
+	const auto peer = history ? history->peer.get() : nullptr;
+	if (!peer
+		|| !(peer->isUser() || peer->isChannel())
+		|| !peer->hasActiveStories()) {
+		return {};
+	}
+	const auto source = peer->owner().stories().source(peer->id);
+	return source
+		? std::make_pair(int(source->ids.size()), source->unreadCount())
+		: std::make_pair(1, peer->hasUnreadStories() ? 1 : 0);
+}
+
+// Rows that wait for a userpic or a preview image to be downloaded.
+[[nodiscard]] bool RowLoading(not_null<Row*> row) {
+	if (row->itemView().loading()) {
+		return true;
+	}
+	const auto history = row->history();
+	const auto peer = history ? history->peer.get() : nullptr;
+	return peer
+		&& peer->hasUserpic()
+		&& peer->useEmptyUserpic(row->userpicView());
+}
+
 } // namespace
 
 struct InnerWidget::CollapsedRow {
@@ -282,10 +318,17 @@ InnerWidget::InnerWidget(
 		_topicJumpCache = nullptr;
 		_chatsFilterTags.clear();
 		_rightButtons.clear();
+		invalidateRowsCache();
+	}, lifetime());
+
+	Lang::Updated(
+	) | rpl::start_with_next([=] {
+		invalidateRowsCache();
 	}, lifetime());
 
 	session().downloaderTaskFinished(
 	) | rpl::start_with_next([=] {
+		invalidateLoadingRowsCache();
 		update();
 	}, lifetime());
 
@@ -293,6 +336,7 @@ InnerWidget::InnerWidget(
 	) | rpl::start_with_next([=](Window::Notifications::ChangeType change) {
 		if (change == Window::Notifications::ChangeType::CountMessages) {
 			// Folder rows change their unread badge with this setting.
+			invalidateRowsCache();
 			update();
 		}
 	}, lifetime());
@@ -422,6 +466,7 @@ InnerWidget::InnerWidget(
 					refresh();
 				}
 			} else {
+				invalidateRowsCache();
 				update();
 			}
 		}, _handleChatListEntryTagRefreshesLifetime);
@@ -440,6 +485,7 @@ InnerWidget::InnerWidget(
 			stopReorderPinned();
 		}
 		if (update.flags & Data::HistoryUpdate::Flag::ChatOccupied) {
+			invalidateRowsCache();
 			this->update();
 			_updated.fire({});
 		}
@@ -465,6 +511,7 @@ InnerWidget::InnerWidget(
 					updateDialogRow({ history, FullMsgId() });
 				}
 			} else {
+				invalidateRowsCache();
 				this->update();
 			}
 			_updated.fire({});
@@ -799,6 +846,30 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 	if (!_savedSublists && _controller->contentOverlapped(this, e)) {
 		return;
 	}
+	const auto trace = Core::StartupTrace::Span("Dialogs::paintEvent");
+	Core::StartupTrace::MarkFirst("Dialogs::painted");
+#ifdef _DEBUG
+	const auto paintStarted = crl::now();
+	const auto paintFinished = gsl::finally([&] {
+		auto &stats = _rowsCacheStats;
+		stats.paintTime += crl::now() - paintStarted;
+		if (++stats.paints == kRowsCacheStatsEach) {
+			DEBUG_LOG(("Dialogs Info: "
+				"%1 paints in %2 ms, rows rasterized %3, reused %4."
+				).arg(stats.paints
+				).arg(stats.paintTime
+				).arg(stats.rasterized
+				).arg(stats.reused));
+			stats = RowsCacheStats();
+		}
+	});
+#endif // _DEBUG
+	if (const auto day = QDate::currentDate().toJulianDay()
+		; _rowsCacheDay != day) {
+		// Dates in the rows are formatted relative to today.
+		_rowsCacheDay = day;
+		invalidateRowsCache();
+	}
 	const auto activeEntry = _controller->activeChatEntryCurrent();
 	const auto videoPaused = _controller->isGifPausedAtLeastFor(
 		Window::GifPauseReason::Any);
@@ -914,7 +985,7 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 		context.topicJumpSelected = selected
 			&& _selectedTopicJump
 			&& (!_pressed || _pressedTopicJump);
-		Ui::RowPainter::Paint(p, row, validateVideoUserpic(row), context);
+		paintRowCached(p, row, validateVideoUserpic(row), context);
 	};
 	if (_state == WidgetState::Default) {
 		const auto collapsedSkip = collapsedRowsOffset();
@@ -1505,6 +1576,133 @@ void InnerWidget::paintPeerSearchResult(
 	result->name.drawElided(p, rectForName.left(), rectForName.top(), rectForName.width());
 }
 
+void InnerWidget::paintRowCached(
+		Painter &p,
+		not_null<Row*> row,
+		Ui::VideoUserpic *videoUserpic,
+		const Ui::PaintContext &context) {
+	const auto entry = row->entry();
+	if (!rowCacheAllowed(row, videoUserpic, context)) {
+		_rowsCache.remove(entry);
+		Ui::RowPainter::Paint(p, row, videoUserpic, context);
+		return;
+	}
+	const auto tags = context.chatsFilterTags
+		? *context.chatsFilterTags
+		: std::vector<QImage*>();
+	const QBrush &brush = context.currentBg;
+	const auto bg = brush.color().rgba();
+	const auto ratio = style::DevicePixelRatio();
+	const auto [stories, storiesUnread] = RowStoriesState(row);
+	auto &cache = _rowsCache[entry];
+	if (cache.row == row.get()
+		&& cache.st == context.st
+		&& cache.tags == tags
+		&& cache.bg == bg
+		&& cache.filter == context.filter
+		&& cache.width == context.width
+		&& cache.height == row->height()
+		&& cache.ratio == ratio
+		&& cache.stories == stories
+		&& cache.storiesUnread == storiesUnread
+		&& cache.active == context.active
+		&& cache.selected == context.selected
+		&& cache.topicJumpSelected == context.topicJumpSelected
+		&& cache.paused == context.paused
+		&& cache.narrow == context.narrow) {
+		entry->chatListPreloadData(); // Allow chat list message resolve.
+		p.drawImage(0, 0, cache.image);
+#ifdef _DEBUG
+		++_rowsCacheStats.reused;
+#endif // _DEBUG
+		return;
+	}
+	const auto size = QSize(context.width, row->height()) * ratio;
+	if (cache.image.size() != size) {
+		cache.image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+		cache.image.setDevicePixelRatio(ratio);
+	}
+	cache.image.fill(Qt::transparent);
+	{
+		auto q = Painter(&cache.image);
+		q.setInactive(context.paused);
+		Ui::RowPainter::Paint(q, row, videoUserpic, context);
+	}
+	cache.row = row.get();
+	cache.st = context.st;
+	cache.tags = tags;
+	cache.bg = bg;
+	cache.filter = context.filter;
+	cache.width = context.width;
+	cache.height = row->height();
+	cache.ratio = ratio;
+	cache.stories = stories;
+	cache.storiesUnread = storiesUnread;
+	cache.loading = RowLoading(row);
+	cache.active = context.active;
+	cache.selected = context.selected;
+	cache.topicJumpSelected = context.topicJumpSelected;
+	cache.paused = context.paused;
+	cache.narrow = context.narrow;
+	p.drawImage(0, 0, cache.image);
+#ifdef _DEBUG
+	++_rowsCacheStats.rasterized;
+#endif // _DEBUG
+
+	if (int(_rowsCache.size()) > kRowsCacheLimit) {
+		// Keep only the rows that are still on the screen.
+		const auto visible = [&](not_null<Entry*> key) {
+			const auto shown = shownRowByKey(key);
+			const auto top = shown ? defaultRowTop(shown) : -1;
+			return shown
+				&& (top + shown->height() > _visibleTop)
+				&& (top < _visibleBottom);
+		};
+		for (auto i = begin(_rowsCache); i != end(_rowsCache);) {
+			if (i->first == entry || visible(i->first)) {
+				++i;
+			} else {
+				i = _rowsCache.erase(i);
+			}
+		}
+	}
+}
+
+bool InnerWidget::rowCacheAllowed(
+		not_null<Row*> row,
+		Ui::VideoUserpic *videoUserpic,
+		const Ui::PaintContext &context) const {
+	// Animated parts are painted directly, every frame.
+	if (videoUserpic
+		|| context.rightButton
+		|| (context.topicsExpanded > 0.)
+		|| row->hasRipple()
+		|| row->topicJumpRipple()) {
+		return false;
+	} else if (const auto thread = row->thread()) {
+		return !thread->sendActionPainter()->animating();
+	}
+	return true;
+}
+
+void InnerWidget::invalidateRowCache(not_null<Entry*> entry) {
+	_rowsCache.remove(entry);
+}
+
+void InnerWidget::invalidateLoadingRowsCache() {
+	for (auto i = begin(_rowsCache); i != end(_rowsCache);) {
+		if (i->second.loading) {
+			i = _rowsCache.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+void InnerWidget::invalidateRowsCache() {
+	_rowsCache.clear();
+}
+
 QBrush InnerWidget::currentBg() const {
 	return anim::brush(
 		st::dialogsBg,
@@ -2528,6 +2726,7 @@ int InnerWidget::defaultRowTop(not_null<Row*> row) const {
 void InnerWidget::repaintDialogRow(
 		FilterId filterId,
 		not_null<Row*> row) {
+	invalidateRowCache(row->entry());
 	if (_state == WidgetState::Default) {
 		if (_filterId == filterId) {
 			if (const auto folder = row->folder()) {
@@ -2601,6 +2800,9 @@ void InnerWidget::updateDialogRow(
 		}
 	}
 
+	if (row.key) {
+		invalidateRowCache(row.key.entry());
+	}
 	const auto updateRow = [&](int rowTop, int rowHeight) {
 		if (!updateRect.isEmpty()) {
 			rtlupdate(updateRect.translated(0, rowTop));
@@ -3612,6 +3814,7 @@ void InnerWidget::editOpenedFilter() {
 }
 
 void InnerWidget::refresh(bool toTop) {
+	invalidateRowsCache();
 	if (!_geometryInited) {
 		return;
 	} else if (needCollapsedRowsRefresh()) {
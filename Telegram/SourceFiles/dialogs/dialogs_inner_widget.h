@@ -249,6 +249,35 @@ private:
 		crl::time animStartTime = 0;
 	};
 
+	// Rasterized row with everything it was painted with.
+	struct RowCache {
+		QImage image;
+		const Row *row = nullptr;
+		const style::DialogRow *st = nullptr;
+		std::vector<QImage*> tags;
+		QRgb bg = 0;
+		FilterId filter = 0;
+		int width = 0;
+		int height = 0;
+		int ratio = 0;
+		int stories = 0;
+		int storiesUnread = 0;
+		bool loading = false;
+		bool active = false;
+		bool selected = false;
+		bool topicJumpSelected = false;
+		bool paused = false;
+		bool narrow = false;
+	};
+#ifdef _DEBUG
+	struct RowsCacheStats {
+		crl::time paintTime = 0;
+		int paints = 0;
+		int rasterized = 0;
+		int reused = 0;
+	};
+#endif // _DEBUG
+
 	struct FilterResult {
 		FilterResult(not_null<Row*> row) : row(row) {
 		}
@@ -440,6 +469,19 @@ private:
 	Ui::VideoUserpic *validateVideoUserpic(not_null<Row*> row);
 	Ui::VideoUserpic *validateVideoUserpic(not_null<History*> history);
 
+	void paintRowCached(
+		Painter &p,
+		not_null<Row*> row,
+		Ui::VideoUserpic *videoUserpic,
+		const Ui::PaintContext &context);
+	[[nodiscard]] bool rowCacheAllowed(
+		not_null<Row*> row,
+		Ui::VideoUserpic *videoUserpic,
+		const Ui::PaintContext &context) const;
+	void invalidateRowCache(not_null<Entry*> entry);
+	void invalidateLoadingRowsCache();
+	void invalidateRowsCache();
+
 	Row *shownRowByKey(Key key);
 	void clearSearchResults(bool clearPeerSearchResults = true);
 	void clearPreviewResults();
@@ -598,6 +640,12 @@ private:
 
 	std::unordered_map<PeerId, RightButton> _rightButtons;
 
+	base::flat_map<not_null<Entry*>, RowCache> _rowsCache;
+	int _rowsCacheDay = 0;
+#ifdef _DEBUG
+	RowsCacheStats _rowsCacheStats;
+#endif // _DEBUG
+
 	Fn<void()> _loadMoreCallback;
 	Fn<void()> _loadMoreFilteredCallback;
 	rpl::event_stream<> _listBottomReached;
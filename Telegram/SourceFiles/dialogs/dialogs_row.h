@@ -69,6 +69,10 @@ public:
 		int outerWidth,
 		const QColor *colorOverride = nullptr) const;
 
+	[[nodiscard]] bool hasRipple() const {
+		return (_ripple != nullptr);
+	}
+
 	[[nodiscard]] Ui::PeerUserpicView &userpicView() const {
 		return _userpic;
 	}
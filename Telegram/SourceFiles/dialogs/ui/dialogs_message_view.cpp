@@ -225,6 +225,10 @@ void MessageView::prepare(
 	}
 }
 
+bool MessageView::loading() const {
+	return (_loadingContext != nullptr);
+}
+
 bool MessageView::isInTopicJump(int x, int y) const {
 	return _topics && _topics->isInTopicJumpArea(x, y);
 }
@@ -57,6 +57,7 @@ public:
 	[[nodiscard]] bool prepared(
 		not_null<const HistoryItem*> item,
 		Data::Forum *forum) const;
+	[[nodiscard]] bool loading() const;
 	void prepare(
 		not_null<const HistoryItem*> item,
 		Data::Forum *forum,
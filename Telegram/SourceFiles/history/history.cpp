@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item_components.h"
 #include "history/history_item_helpers.h"
 #include "history/history_translation.h"
+#include "history/history_search_index.h"
 #include "history/history_unread_things.h"
 #include "core/ui_integration.h"
 #include "dialogs/ui/dialogs_layout.h"
@@ -156,6 +157,9 @@ void History::itemRemoved(not_null<HistoryItem*> item) {
 	}
 	checkChatListMessageRemoved(item);
 	itemVanished(item);
+	if (_searchIndex) {
+		_searchIndex->itemRemoved(item);
+	}
 	if (IsClientMsgId(item->id)) {
 		unregisterClientSideMessage(item);
 	}
@@ -1389,6 +1393,9 @@ void History::addItemToBlock(not_null<HistoryItem*> item) {
 	block->messages.push_back(item->createView(_delegateMixin->delegate()));
 	const auto view = block->messages.back().get();
 	view->attachToBlock(block, block->messages.size() - 1);
+	if (_searchIndex) {
+		_searchIndex->itemAdded(item);
+	}
 
 	if (isBuildingFrontBlock() && _buildingFrontBlock->expectedItemsCount > 0) {
 		--_buildingFrontBlock->expectedItemsCount;
@@ -2194,6 +2201,9 @@ not_null<HistoryItem*> History::addNewInTheMiddle(
 		block->messages.begin() + itemIndex,
 		item->createView(_delegateMixin->delegate()));
 	(*it)->attachToBlock(block.get(), itemIndex);
+	if (_searchIndex) {
+		_searchIndex->itemAdded(item);
+	}
 	if (itemIndex + 1 < block->messages.size()) {
 		for (auto i = itemIndex + 1, l = int(block->messages.size()); i != l; ++i) {
 			block->messages[i]->setIndexInBlock(i);
@@ -3544,6 +3554,7 @@ void History::clear(ClearType type) {
 	_unreadBarView = nullptr;
 	_firstUnreadView = nullptr;
 	removeJoinedMessage();
+	clearSearchIndex();
 
 	forgetScrollState();
 	blocks.clear();
@@ -3711,6 +3722,23 @@ HistoryTranslation *History::translation() const {
 	return _translation.get();
 }
 
+not_null<HistorySearchIndex*> History::searchIndex() {
+	if (!_searchIndex) {
+		_searchIndex = std::make_unique<HistorySearchIndex>(this);
+	}
+	return _searchIndex.get();
+}
+
+void History::searchIndexItemChanged(not_null<HistoryItem*> item) {
+	if (_searchIndex) {
+		_searchIndex->itemChanged(item);
+	}
+}
+
+void History::clearSearchIndex() {
+	_searchIndex = nullptr;
+}
+
 HistoryBlock::HistoryBlock(not_null<History*> history)
 : _history(history) {
 }
@@ -19,6 +19,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 class History;
 class HistoryBlock;
 class HistoryTranslation;
+class HistorySearchIndex;
 class HistoryItem;
 struct HistoryItemCommonFields;
 struct HistoryMessageMarkupData;
@@ -399,6 +400,10 @@ public:
 
 	[[nodiscard]] HistoryTranslation *translation() const;
 
+	[[nodiscard]] not_null<HistorySearchIndex*> searchIndex();
+	void searchIndexItemChanged(not_null<HistoryItem*> item);
+	void clearSearchIndex();
+
 	const not_null<PeerData*> peer;
 
 	// Still public data.
@@ -598,6 +603,7 @@ private:
 	};
 	std::unique_ptr<BuildingBlock> _buildingFrontBlock;
 	std::unique_ptr<HistoryTranslation> _translation;
+	std::unique_ptr<HistorySearchIndex> _searchIndex;
 
 	Data::HistoryDrafts _drafts;
 	base::flat_map<MsgId, TimeId> _acceptCloudDraftsAfter;
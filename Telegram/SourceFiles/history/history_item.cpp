@@ -3418,6 +3418,7 @@ void HistoryItem::setTextValue(TextWithEntities text, bool force) {
 	if (had || force) {
 		history()->owner().requestItemTextRefresh(this);
 	}
+	history()->searchIndexItemChanged(this);
 }
 
 bool HistoryItem::inHighlightProcess() const {
@@ -467,7 +467,8 @@ void RequestDependentMessageItem(
 	history->session().api().requestMessageData(
 		(peerId ? history->owner().peer(peerId) : history->peer),
 		msgId,
-		done);
+		done,
+		ApiWrap::MessageDataPriority::Background);
 }
 
 void RequestDependentMessageStory(
@@ -0,0 +1,226 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "history/history_search_index.h"
+
+#include "data/data_peer.h"
+#include "data/data_session.h"
+#include "history/view/history_view_element.h"
+#include "history/history.h"
+#include "history/history_item.h"
+
+namespace {
+
+constexpr auto kMaxPostings = 256 * 1024;
+constexpr auto kMaxWordsPerMessage = 256;
+constexpr auto kMaxResults = 1000;
+
+void SortIds(std::vector<MsgId> &ids, bool &sorted) {
+	if (!sorted) {
+		ranges::sort(ids);
+		sorted = true;
+	}
+}
+
+} // namespace
+
+HistorySearchIndex::HistorySearchIndex(not_null<History*> history)
+: _history(history) {
+	for (const auto &block : _history->blocks) {
+		for (const auto &view : block->messages) {
+			add(view->data());
+		}
+	}
+}
+
+void HistorySearchIndex::add(not_null<HistoryItem*> item) {
+	if (!item->isRegular()
+		|| item->isService()
+		|| _indexed.contains(item->id)) {
+		return;
+	}
+	auto words = TextUtilities::PrepareSearchWords(
+		item->originalText().text);
+	words.removeDuplicates();
+	if (words.size() > kMaxWordsPerMessage) {
+		words = words.mid(0, kMaxWordsPerMessage);
+	}
+	if (_postings + int(words.size()) > kMaxPostings) {
+		if (!_indexed.empty() && item->id < _indexed.begin()->first) {
+			// Older than everything indexed, it would be evicted first.
+			return;
+		}
+		evictOldest(int(words.size()));
+	}
+	auto &keys = _indexed.emplace(
+		item->id,
+		std::vector<QString>()).first->second;
+	keys.reserve(words.size());
+	for (const auto &word : words) {
+		const auto i = _words.emplace(word, Posting()).first;
+		auto &posting = i->second;
+		if (!posting.ids.empty() && posting.ids.back() > item->id) {
+			posting.sorted = false;
+		}
+		posting.ids.push_back(item->id);
+		keys.push_back(i->first);
+	}
+	_postings += int(keys.size());
+}
+
+void HistorySearchIndex::remove(
+		MsgId id,
+		const std::vector<QString> &words) {
+	for (const auto &word : words) {
+		const auto i = _words.find(word);
+		if (i == end(_words)) {
+			continue;
+		}
+		auto &posting = i->second;
+		SortIds(posting.ids, posting.sorted);
+		const auto j = ranges::lower_bound(posting.ids, id);
+		if (j != end(posting.ids) && *j == id) {
+			posting.ids.erase(j);
+		}
+		if (posting.ids.empty()) {
+			_words.erase(i);
+		}
+	}
+	_postings -= int(words.size());
+}
+
+void HistorySearchIndex::evictOldest(int required) {
+	// Evict a batch, so that the following additions don't evict again.
+	const auto target = std::max(kMaxPostings * 3 / 4 - required, 0);
+	auto till = begin(_indexed);
+	auto evicted = 0;
+	auto touched = std::vector<QString>();
+	while (till != end(_indexed) && _postings > target) {
+		_postings -= int(till->second.size());
+		touched.insert(
+			end(touched),
+			begin(till->second),
+			end(till->second));
+		++till;
+		++evicted;
+	}
+	ranges::sort(touched);
+	touched.erase(ranges::unique(touched), end(touched));
+
+	// All the evicted ids are less than the first one that is kept,
+	// so each touched posting loses its sorted prefix in one erase.
+	const auto kept = (till != end(_indexed))
+		? std::make_optional(till->first)
+		: std::nullopt;
+	for (const auto &word : touched) {
+		const auto i = _words.find(word);
+		if (i == end(_words)) {
+			continue;
+		}
+		auto &posting = i->second;
+		SortIds(posting.ids, posting.sorted);
+		posting.ids.erase(
+			begin(posting.ids),
+			kept ? ranges::lower_bound(posting.ids, *kept) : end(posting.ids));
+		if (posting.ids.empty()) {
+			_words.erase(i);
+		}
+	}
+	DEBUG_LOG(("History Search Index: Evicted %1 messages in %2."
+		).arg(evicted
+		).arg(_history->peer->id.value));
+	_indexed.erase(begin(_indexed), till);
+}
+
+void HistorySearchIndex::itemAdded(not_null<HistoryItem*> item) {
+	add(item);
+}
+
+void HistorySearchIndex::itemChanged(not_null<HistoryItem*> item) {
+	const auto i = _indexed.find(item->id);
+	if (i == end(_indexed)) {
+		return;
+	}
+	remove(i->first, i->second);
+	_indexed.erase(i);
+	add(item);
+}
+
+void HistorySearchIndex::itemRemoved(not_null<HistoryItem*> item) {
+	const auto i = _indexed.find(item->id);
+	if (i != end(_indexed)) {
+		remove(i->first, i->second);
+		_indexed.erase(i);
+	}
+}
+
+std::vector<MsgId> HistorySearchIndex::collect(
+		const QString &word) const {
+	auto result = std::vector<MsgId>();
+	for (auto i = _words.lower_bound(word); i != end(_words); ++i) {
+		if (!i->first.startsWith(word)) {
+			break;
+		}
+		const auto &ids = i->second.ids;
+		result.insert(end(result), begin(ids), end(ids));
+	}
+	ranges::sort(result);
+	result.erase(ranges::unique(result), end(result));
+	return result;
+}
+
+bool HistorySearchIndex::matches(
+		not_null<HistoryItem*> item,
+		const Query &query,
+		const QStringList &words) const {
+	if (query.from && item->from() != query.from) {
+		return false;
+	} else if (query.topMsgId && !item->inThread(query.topMsgId)) {
+		return false;
+	}
+	const auto itemWords = TextUtilities::PrepareSearchWords(
+		item->originalText().text);
+	for (const auto &word : words) {
+		const auto found = ranges::any_of(itemWords, [&](
+				const QString &itemWord) {
+			return itemWord.startsWith(word);
+		});
+		if (!found) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<MsgId> HistorySearchIndex::search(const Query &query) const {
+	const auto words = TextUtilities::PrepareSearchWords(query.text);
+	if (words.isEmpty()) {
+		return {};
+	}
+
+	auto candidates = collect(words.front());
+	for (auto i = 1; i < words.size() && !candidates.empty(); ++i) {
+		const auto other = collect(words[i]);
+		auto both = std::vector<MsgId>();
+		ranges::set_intersection(candidates, other, back_inserter(both));
+		candidates = std::move(both);
+	}
+
+	auto result = std::vector<MsgId>();
+	const auto owner = &_history->owner();
+	const auto peerId = _history->peer->id;
+	for (auto i = candidates.rbegin(); i != candidates.rend(); ++i) {
+		const auto item = owner->message(peerId, *i);
+		if (item && matches(item, query, words)) {
+			result.push_back(*i);
+			if (int(result.size()) == kMaxResults) {
+				break;
+			}
+		}
+	}
+	return result;
+}
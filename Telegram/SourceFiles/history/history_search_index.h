@@ -0,0 +1,56 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class History;
+class HistoryItem;
+class PeerData;
+
+// Word index over the messages loaded in History::blocks, used to show
+// search results before (or without) the server answering.
+class HistorySearchIndex final {
+public:
+	struct Query {
+		QString text;
+		PeerData *from = nullptr;
+		MsgId topMsgId;
+	};
+
+	// Indexes the messages that are already in History::blocks.
+	explicit HistorySearchIndex(not_null<History*> history);
+
+	// Found ids are sorted from the newest to the oldest one.
+	[[nodiscard]] std::vector<MsgId> search(const Query &query) const;
+
+	void itemAdded(not_null<HistoryItem*> item);
+	void itemChanged(not_null<HistoryItem*> item);
+	void itemRemoved(not_null<HistoryItem*> item);
+
+private:
+	// Ids are appended unsorted, older slices usually come after newer.
+	struct Posting {
+		std::vector<MsgId> ids;
+		bool sorted = true;
+	};
+
+	void add(not_null<HistoryItem*> item);
+	void remove(MsgId id, const std::vector<QString> &words);
+	void evictOldest(int required);
+	[[nodiscard]] std::vector<MsgId> collect(const QString &word) const;
+	[[nodiscard]] bool matches(
+		not_null<HistoryItem*> item,
+		const Query &query,
+		const QStringList &words) const;
+
+	const not_null<History*> _history;
+
+	std::map<QString, Posting> _words;
+	std::map<MsgId, std::vector<QString>> _indexed;
+	int _postings = 0;
+
+};
@@ -211,7 +211,7 @@ void Proxy::checkAdd(MsgId msgId, bool resolved) {
 	} else if (!item && !resolved) {
 		peer->session().api().requestMessageData(peer, msgId, [=] {
 			history->unreadReactions().checkAdd(msgId, true);
-		});
+		}, ApiWrap::MessageDataPriority::Background);
 	}
 }
 
@@ -167,6 +167,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "info/profile/info_profile_values.h" // SharedMediaCountValue.
 #include "chat_helpers/emoji_suggestions_widget.h"
 #include "core/shortcuts.h"
+#include "core/startup_trace.h"
 #include "core/ui_integration.h"
 #include "support/support_common.h"
 #include "support/support_autocomplete.h"
@@ -2236,6 +2237,10 @@ void HistoryWidget::showHistory(
 		PeerId peerId,
 		MsgId showAtMsgId,
 		const Window::SectionShow &params) {
+	const auto trace = Core::StartupTrace::Span("HistoryWidget::showHistory");
+	if (peerId) {
+		Core::StartupTrace::MarkFirst("HistoryWidget::chatOpened");
+	}
 	_pinnedClickedId = FullMsgId();
 	_minPinnedId = std::nullopt;
 	_showAtMsgParams = {};
@@ -2428,6 +2433,7 @@ void HistoryWidget::showHistory(
 	if (peerId) {
 		using namespace HistoryView;
 		_peer = session().data().peer(peerId);
+		session().api().messageDataChatOpened(_peer);
 		_contactStatus = std::make_unique<ContactStatus>(
 			controller(),
 			this,
@@ -614,6 +614,7 @@ public:
 	BottomBar(not_null<Ui::RpWidget*> parent, bool fastShowChooseFrom);
 
 	void setTotal(int total);
+	void updateTotal(int total);
 	void setCurrent(int current);
 
 	[[nodiscard]] rpl::producer<Index> showItemRequests() const;
@@ -627,6 +628,7 @@ public:
 	bool handleKeyPress(not_null<QKeyEvent*> e);
 
 private:
+	void updateNavigation(int current);
 	void updateText(int current);
 
 	base::unique_qptr<Ui::FlatButton> _showList;
@@ -712,25 +714,7 @@ BottomBar::BottomBar(not_null<Ui::RpWidget*> parent, bool fastShowChooseFrom)
 
 	_current.value(
 	) | rpl::start_with_next([=](int current) {
-		const auto nextDisabled = (current <= 0) || (current >= _total);
-		const auto prevDisabled = (current <= 1);
-		_next.enabled = !nextDisabled;
-		_previous.enabled = !prevDisabled;
-		_next->setAttribute(Qt::WA_TransparentForMouseEvents, nextDisabled);
-		_previous->setAttribute(
-			Qt::WA_TransparentForMouseEvents,
-			prevDisabled);
-		_next->setIconOverride(nextDisabled
-			? &st::calendarPreviousDisabled
-			: nullptr);
-		_previous->setIconOverride(prevDisabled
-			? &st::calendarNextDisabled
-			: nullptr);
-
-		_showList->setAttribute(
-			Qt::WA_TransparentForMouseEvents,
-			nextDisabled && prevDisabled);
-		updateText(current);
+		updateNavigation(current);
 	}, lifetime());
 
 	rpl::merge(
@@ -774,10 +758,35 @@ void BottomBar::setTotal(int total) {
 	setCurrent(1);
 }
 
+void BottomBar::updateTotal(int total) {
+	_total = total;
+	updateNavigation(_current.current());
+}
+
 void BottomBar::setCurrent(int current) {
 	_current.force_assign(current);
 }
 
+void BottomBar::updateNavigation(int current) {
+	const auto nextDisabled = (current <= 0) || (current >= _total);
+	const auto prevDisabled = (current <= 1);
+	_next.enabled = !nextDisabled;
+	_previous.enabled = !prevDisabled;
+	_next->setAttribute(Qt::WA_TransparentForMouseEvents, nextDisabled);
+	_previous->setAttribute(Qt::WA_TransparentForMouseEvents, prevDisabled);
+	_next->setIconOverride(nextDisabled
+		? &st::calendarPreviousDisabled
+		: nullptr);
+	_previous->setIconOverride(prevDisabled
+		? &st::calendarNextDisabled
+		: nullptr);
+
+	_showList->setAttribute(
+		Qt::WA_TransparentForMouseEvents,
+		nextDisabled && prevDisabled);
+	updateText(current);
+}
+
 void BottomBar::updateText(int current) {
 	if (_total < 0) {
 		_counter->setText(QString());
@@ -866,6 +875,9 @@ private:
 		rpl::event_stream<BottomBar::Index> jumps;
 	} _pendingJump;
 
+	// First result of the current search, that was already shown.
+	FullMsgId _firstFound;
+
 	MsgId _topMsgId;
 
 	rpl::event_stream<Activation> _activations;
@@ -911,6 +923,7 @@ ComposeSearch::Inner::Inner(
 			}
 		}
 		search.topMsgId = _topMsgId;
+		_firstFound = FullMsgId();
 		_apiSearch.clear();
 		_apiSearch.search(search);
 	}, _topBar->lifetime());
@@ -937,6 +950,16 @@ ComposeSearch::Inner::Inner(
 	_apiSearch.newFounds(
 	) | rpl::start_with_next([=] {
 		const auto &apiData = _apiSearch.messages();
+		const auto first = apiData.messages.empty()
+			? FullMsgId()
+			: apiData.messages.front();
+		const auto shown = std::exchange(_firstFound, first);
+		if (first && first == shown) {
+			// The server results start with the local one already shown.
+			_bottomBar->updateTotal(apiData.total);
+			_list.controller->addItems(apiData.messages, true);
+			return;
+		}
 		const auto weak = Ui::MakeWeak(_bottomBar.get());
 		_bottomBar->setTotal(apiData.total);
 		if (weak) {
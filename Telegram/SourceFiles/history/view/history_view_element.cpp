@@ -55,6 +55,12 @@ namespace {
 // A new message from the same sender is attached to previous within 15 minutes.
 constexpr int kAttachMessageToPreviousSecondsDelta = 900;
 
+// Parsed layouts of shorter texts are cheap enough to always keep.
+constexpr auto kEvictTextMinLength = 256;
+
+// Heights of evictable texts are remembered for a few last widths.
+constexpr auto kTextHeightsCached = 4;
+
 Element *HoveredElement/* = nullptr*/;
 Element *PressedElement/* = nullptr*/;
 Element *HoveredLinkElement/* = nullptr*/;
@@ -845,6 +851,8 @@ void Element::overrideMedia(std::unique_ptr<Media> media) {
 	_text = Ui::Text::String(st::msgMinWidth);
 	_textWidth = -1;
 	_textHeight = 0;
+	_textHeights.clear();
+	_flags &= ~(Flag::TextEvicted | Flag::TextHeightEstimated);
 
 	_media = std::move(media);
 	if (!pendingResize()) {
@@ -949,21 +957,26 @@ HistoryItem *Element::textItem() const {
 }
 
 Ui::Text::IsolatedEmoji Element::isolatedEmoji() const {
-	return _text.toIsolatedEmoji();
+	return text().toIsolatedEmoji();
 }
 
 Ui::Text::OnlyCustomEmoji Element::onlyCustomEmoji() const {
-	return _text.toOnlyCustomEmoji();
+	return text().toOnlyCustomEmoji();
 }
 
 const Ui::Text::String &Element::text() const {
+	if (_flags & Flag::TextEvicted) {
+		const_cast<Element*>(this)->restoreText();
+	} else if (_flags & Flag::EvictableText) {
+		history()->owner().touchEvictableText(const_cast<Element*>(this));
+	}
 	return _text;
 }
 
 OnlyEmojiAndSpaces Element::isOnlyEmojiAndSpaces() const {
 	if (data()->Has<HistoryMessageTranslation>()) {
 		return OnlyEmojiAndSpaces::No;
-	} else if (!_text.isEmpty()) {
+	} else if (!text().isEmpty()) {
 		return _text.hasNotEmojiAndSpaces()
 			? OnlyEmojiAndSpaces::No
 			: OnlyEmojiAndSpaces::Yes;
@@ -975,14 +988,61 @@ OnlyEmojiAndSpaces Element::isOnlyEmojiAndSpaces() const {
 }
 
 int Element::textHeightFor(int textWidth) {
+	if ((_flags & Flag::TextEvicted) && _textWidth != textWidth) {
+		// Don't parse the evicted text only to measure it.
+		if (const auto height = evictedTextHeight(textWidth)) {
+			_textWidth = textWidth;
+			_textHeight = *height;
+		}
+	}
+	if (_textWidth == textWidth) {
+		return _textHeight;
+	}
 	validateText();
 	if (_textWidth != textWidth) {
 		_textWidth = textWidth;
 		_textHeight = _text.countHeight(textWidth);
+		rememberTextHeight();
 	}
 	return _textHeight;
 }
 
+std::optional<int> Element::evictedTextHeight(int textWidth) {
+	if (_textHeights.empty()) {
+		return std::nullopt;
+	} else if (const auto i = _textHeights.find(textWidth)
+		; i != end(_textHeights)) {
+		_flags &= ~Flag::TextHeightEstimated;
+		return i->second;
+	}
+
+	// The estimate is checked when the text is parsed for painting.
+	const auto nearest = ranges::min_element(
+		_textHeights,
+		ranges::less(),
+		[&](const auto &pair) { return std::abs(pair.first - textWidth); });
+	const auto line = st::msgFont->height;
+	const auto height = nearest->second * nearest->first / textWidth;
+	_flags |= Flag::TextHeightEstimated;
+	return std::max((height + line - 1) / line, 1) * line;
+}
+
+void Element::rememberTextHeight() {
+	if (!(_flags & Flag::EvictableText) || _textWidth <= 0) {
+		return;
+	}
+	_textHeights[_textWidth] = _textHeight;
+	if (int(_textHeights.size()) > kTextHeightsCached) {
+		const auto farthest = ranges::max_element(
+			_textHeights,
+			ranges::less(),
+			[&](const auto &pair) {
+				return std::abs(pair.first - _textWidth);
+			});
+		_textHeights.erase(farthest);
+	}
+}
+
 auto Element::contextDependentServiceText() -> TextWithLinks {
 	const auto item = data();
 	const auto info = item->Get<HistoryServiceTopicInfo>();
@@ -1124,6 +1184,10 @@ auto Element::contextDependentServiceText() -> TextWithLinks {
 }
 
 void Element::validateText() {
+	if (_flags & Flag::TextEvicted) {
+		restoreText();
+		return;
+	}
 	const auto item = data();
 	const auto media = item->media();
 	const auto storyMention = media && media->storyMention();
@@ -1204,18 +1268,93 @@ void Element::setTextWithLinks(
 	InitElementTextPart(this, _text);
 	_textWidth = -1;
 	_textHeight = 0;
+	_textHeights.clear();
+	if (textEvictable()) {
+		_flags |= Flag::EvictableText;
+		history()->owner().touchEvictableText(this);
+	} else if (_flags & Flag::EvictableText) {
+		_flags &= ~Flag::EvictableText;
+		history()->owner().unregisterEvictableText(this);
+	}
+}
+
+bool Element::textEvictable() const {
+	// Spoilers and collapsed quotes keep their state inside the layout,
+	// special emoji views are backed by a media created from the text.
+	return (_text.length() >= kEvictTextMinLength)
+		&& !(_flags & Flag::SpecialOnlyEmoji)
+		&& !(_media && !data()->media())
+		&& !_text.hasSpoilers()
+		&& !_text.hasCollapsedBlockquots();
+}
+
+void Element::evictText() {
+	_flags &= ~Flag::EvictableText;
+	if (!textEvictable()) {
+		return;
+	}
+	_text = Ui::Text::String(st::msgMinWidth);
+	_flags |= Flag::TextEvicted;
+}
+
+void Element::restoreText() {
+	_flags &= ~Flag::TextEvicted;
+
+	// The layout is parsed again from the item, the measured height of
+	// the whole element stays cached until the next real resize.
+	const auto textWidth = _textWidth;
+	const auto textHeight = _textHeight;
+	auto textHeights = base::take(_textHeights);
+	validateText();
+	if (_textSkipBlock.isValid()) {
+		_text.updateSkipBlock(
+			_textSkipBlock.width(),
+			_textSkipBlock.height());
+	}
+	_textWidth = textWidth;
+	_textHeight = textHeight;
+	_textHeights = std::move(textHeights);
+	if (!(_flags & Flag::TextHeightEstimated)) {
+		return;
+	}
+	_flags &= ~Flag::TextHeightEstimated;
+	if (_textWidth > 0 && _text.countHeight(_textWidth) != _textHeight) {
+		_textWidth = -1;
+		_textHeight = 0;
+
+		// We may be painting right now, so resize a bit later.
+		crl::on_main(this, [=] {
+			history()->owner().requestViewResize(this);
+		});
+	} else {
+		rememberTextHeight();
+	}
 }
 
 void Element::validateTextSkipBlock(bool has, int width, int height) {
+	const auto skipBlock = has ? QSize(width, height) : QSize();
+	if (_flags & Flag::TextEvicted) {
+		// The skip block is applied when the text is parsed again.
+		if (_textSkipBlock != skipBlock) {
+			_textSkipBlock = skipBlock;
+			_textWidth = -1;
+			_textHeight = 0;
+			_textHeights.clear();
+		}
+		return;
+	}
 	validateText();
+	_textSkipBlock = skipBlock;
 	if (!has) {
 		if (_text.removeSkipBlock()) {
 			_textWidth = -1;
 			_textHeight = 0;
+			_textHeights.clear();
 		}
 	} else if (_text.updateSkipBlock(width, height)) {
 		_textWidth = -1;
 		_textHeight = 0;
+		_textHeights.clear();
 	}
 }
 
@@ -1753,6 +1892,8 @@ void Element::itemTextUpdated() {
 	_text = Ui::Text::String(st::msgMinWidth);
 	_textWidth = -1;
 	_textHeight = 0;
+	_textHeights.clear();
+	_flags &= ~(Flag::TextEvicted | Flag::TextHeightEstimated);
 	if (_media && !data()->media()) {
 		refreshMedia(nullptr);
 	}
@@ -1761,6 +1902,7 @@ void Element::itemTextUpdated() {
 void Element::blockquoteExpandChanged() {
 	_textWidth = -1;
 	_textHeight = 0;
+	_textHeights.clear();
 	history()->owner().requestViewResize(this);
 }
 
@@ -2114,6 +2256,10 @@ Element::~Element() {
 		_text.unloadPersistentAnimation();
 		checkHeavyPart();
 	}
+	if (_flags & Flag::EvictableText) {
+		_flags &= ~Flag::EvictableText;
+		history()->owner().unregisterEvictableText(this);
+	}
 	if (_data->mainView() == this) {
 		_data->clearMainView();
 	}
@@ -333,6 +333,9 @@ public:
 		TopicRootReply           = 0x0400,
 		MediaOverriden           = 0x0800,
 		HeavyCustomEmoji         = 0x1000,
+		EvictableText            = 0x2000,
+		TextEvicted              = 0x4000,
+		TextHeightEstimated      = 0x8000,
 	};
 	using Flags = base::flags<Flag>;
 	friend inline constexpr auto is_flag_type(Flag) { return true; }
@@ -524,6 +527,9 @@ public:
 	virtual void unloadHeavyPart();
 	void checkHeavyPart();
 
+	// Drops the parsed text layout, it is parsed again when needed.
+	void evictText();
+
 	void paintCustomHighlight(
 		Painter &p,
 		const PaintContext &context,
@@ -654,6 +660,10 @@ private:
 	void setTextWithLinks(
 		const TextWithEntities &text,
 		const std::vector<ClickHandlerPtr> &links = {});
+	[[nodiscard]] bool textEvictable() const;
+	void restoreText();
+	[[nodiscard]] std::optional<int> evictedTextHeight(int textWidth);
+	void rememberTextHeight();
 	void setReactions(std::unique_ptr<Reactions::InlineList> list);
 
 	struct TextWithLinks {
@@ -673,6 +683,8 @@ private:
 	mutable Ui::Text::String _text;
 	mutable int _textWidth = -1;
 	mutable int _textHeight = 0;
+	QSize _textSkipBlock;
+	base::flat_map<int, int> _textHeights;
 
 	int _y = 0;
 	int _indexInBlock = -1;
@@ -49,6 +49,8 @@ public:
 		style::color color,
 		crl::time now);
 
+	[[nodiscard]] bool animating() const;
+
 	bool updateNeedsAnimating(
 		crl::time now,
 		bool force = false);
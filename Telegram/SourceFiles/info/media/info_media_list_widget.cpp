@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "info/info_controller.h"
 #include "layout/layout_mosaic.h"
 #include "layout/layout_selection.h"
+#include "overview/overview_thumbnails.h"
 #include "data/data_media_types.h"
 #include "data/data_photo.h"
 #include "data/data_chat.h"
@@ -73,6 +74,8 @@ namespace Media {
 namespace {
 
 constexpr auto kMediaCountForSearch = 10;
+constexpr auto kScrollVelocityTimeout = crl::time(200);
+constexpr auto kThumbnailsLookahead = crl::time(500);
 
 } // namespace
 
@@ -146,6 +149,7 @@ ListWidget::ListWidget(
 : RpWidget(parent)
 , _controller(controller)
 , _provider(MakeProvider(_controller))
+, _thumbnails(std::make_unique<Overview::Layout::ThumbnailPreparer>())
 , _dateBadge(std::make_unique<DateBadge>(
 		_provider->type(),
 		[=] { scrollDateCheck(); },
@@ -168,6 +172,7 @@ void ListWidget::start() {
 			_overLayout = nullptr;
 		}
 		_heavyLayouts.remove(layout);
+		_thumbnails->cancel(layout);
 	}, lifetime());
 
 	_provider->refreshed(
@@ -300,6 +305,7 @@ void ListWidget::restart() {
 	_overLayout = nullptr;
 	_sections.clear();
 	_heavyLayouts.clear();
+	_thumbnails->cancelAll();
 
 	_provider->restart();
 }
@@ -488,6 +494,42 @@ bool ListWidget::itemVisible(not_null<const BaseLayout*> item) {
 	return true;
 }
 
+void ListWidget::prepareThumbnail(
+		not_null<const BaseLayout*> item,
+		Overview::Layout::ThumbnailRequest &&request,
+		Fn<void(QImage)> done) {
+	const auto priority = thumbnailPriority(
+		item,
+		std::numeric_limits<int>::min(),
+		std::numeric_limits<int>::max());
+	if (!priority) {
+		done(QImage());
+		return;
+	}
+	_thumbnails->prepare(
+		item,
+		std::move(request),
+		*priority,
+		std::move(done));
+}
+
+std::optional<int> ListWidget::thumbnailPriority(
+		not_null<const BaseLayout*> item,
+		int windowTop,
+		int windowBottom) {
+	const auto found = findItemByItem(item->getItem());
+	if (!found || found->layout.get() != item.get()) {
+		return std::nullopt;
+	}
+	const auto top = found->geometry.y();
+	const auto bottom = top + found->geometry.height();
+	if (bottom <= windowTop || top >= windowBottom) {
+		return std::nullopt;
+	}
+	// Visible items go first, then the closest ones.
+	return std::max({ 0, _visibleTop - bottom, top - _visibleBottom });
+}
+
 QString ListWidget::tooltipText() const {
 	if (const auto link = ClickHandler::getActive()) {
 		return link->tooltip();
@@ -639,11 +681,13 @@ auto ListWidget::foundItemInSection(
 void ListWidget::visibleTopBottomUpdated(
 		int visibleTop,
 		int visibleBottom) {
+	updateScrollVelocity(visibleTop);
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 
 	checkMoveToOtherViewer();
 	clearHeavyItems();
+	updateThumbnailsWindow();
 
 	if (_dateBadge->goodType) {
 		updateDateBadgeFor(_visibleTop);
@@ -748,6 +792,55 @@ void ListWidget::clearHeavyItems() {
 	}
 }
 
+void ListWidget::updateScrollVelocity(int visibleTop) {
+	const auto now = crl::now();
+	const auto elapsed = now - _scrollVelocityTime;
+	if (_scrollVelocityTime
+		&& elapsed > 0
+		&& elapsed < kScrollVelocityTimeout) {
+		const auto velocity = (visibleTop - _visibleTop) / float64(elapsed);
+		_scrollVelocity = (_scrollVelocity + velocity) / 2.;
+	} else {
+		_scrollVelocity = 0.;
+	}
+	_scrollVelocityTime = now;
+}
+
+void ListWidget::updateThumbnailsWindow() {
+	const auto visibleHeight = _visibleBottom - _visibleTop;
+	if (visibleHeight <= 0) {
+		return;
+	}
+
+	// Prefetch in the scroll direction as far as we'll get in a moment,
+	// but not further than the heavy parts are kept by clearHeavyItems().
+	const auto ahead = std::clamp(
+		int(std::abs(_scrollVelocity) * kThumbnailsLookahead),
+		visibleHeight / 4,
+		visibleHeight);
+	const auto behind = visibleHeight / 4;
+	const auto down = (_scrollVelocity >= 0.);
+	const auto top = _visibleTop - (down ? behind : ahead);
+	const auto bottom = _visibleBottom + (down ? ahead : behind);
+
+	_thumbnails->refreshPriorities([&](not_null<const BaseLayout*> item) {
+		return thumbnailPriority(item, top, bottom);
+	});
+	for (const auto &section : _sections) {
+		if (section.bottom() <= top) {
+			continue;
+		} else if (section.top() >= bottom) {
+			break;
+		}
+		for (const auto &item : section.items()) {
+			const auto rect = findItemDetails(item).geometry;
+			if (rect.y() + rect.height() > top && rect.y() < bottom) {
+				item->prefetchThumbnail();
+			}
+		}
+	}
+}
+
 ListScrollTopState ListWidget::countScrollState() const {
 	if (_sections.empty() || _visibleTop <= 0) {
 		return {};
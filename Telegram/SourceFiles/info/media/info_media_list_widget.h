@@ -34,6 +34,7 @@ class BoxContent;
 namespace Overview {
 namespace Layout {
 class ItemBase;
+class ThumbnailPreparer;
 } // namespace Layout
 } // namespace Overview
 
@@ -84,6 +85,10 @@ public:
 	void unregisterHeavyItem(not_null<const BaseLayout*> item) override;
 	void repaintItem(not_null<const BaseLayout*> item) override;
 	bool itemVisible(not_null<const BaseLayout*> item) override;
+	void prepareThumbnail(
+		not_null<const BaseLayout*> item,
+		Overview::Layout::ThumbnailRequest &&request,
+		Fn<void(QImage)> done) override;
 
 	// AbstractTooltipShower interface
 	QString tooltipText() const override;
@@ -270,11 +275,18 @@ private:
 	void validateTrippleClickStartTime();
 	void checkMoveToOtherViewer();
 	void clearHeavyItems();
+	void updateScrollVelocity(int visibleTop);
+	void updateThumbnailsWindow();
+	[[nodiscard]] std::optional<int> thumbnailPriority(
+		not_null<const BaseLayout*> item,
+		int windowTop,
+		int windowBottom);
 
 	void setActionBoxWeak(QPointer<Ui::BoxContent> box);
 
 	const not_null<AbstractController*> _controller;
 	const std::unique_ptr<ListProvider> _provider;
+	const std::unique_ptr<Overview::Layout::ThumbnailPreparer> _thumbnails;
 
 	base::flat_set<not_null<const BaseLayout*>> _heavyLayouts;
 	bool _heavyLayoutsInvalidated = false;
@@ -282,6 +294,8 @@ private:
 
 	int _visibleTop = 0;
 	int _visibleBottom = 0;
+	float64 _scrollVelocity = 0.;
+	crl::time _scrollVelocityTime = 0;
 	ListScrollTopState _scrollTopState;
 	rpl::event_stream<int> _scrollToRequests;
 
@@ -16,6 +16,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/platform/base_platform_info.h"
 #include "base/qthelp_regex.h"
 
+#include <mutex>
+
 namespace Lang {
 namespace {
 
@@ -25,15 +27,6 @@ constexpr auto kCloudLangPackName = "tdesktop"_cs;
 constexpr auto kCustomLanguage = "#custom"_cs;
 constexpr auto kLangValuesLimit = 20000;
 
-std::vector<QString> PrepareDefaultValues() {
-	auto result = std::vector<QString>();
-	result.reserve(kKeysCount);
-	for (auto i = 0; i != kKeysCount; ++i) {
-		result.emplace_back(GetOriginalValue(ushort(i)));
-	}
-	return result;
-}
-
 class ValueParser {
 public:
 	ValueParser(
@@ -49,6 +42,9 @@ public:
 
 	bool parse();
 
+	// Checks the tags without building the result.
+	bool validate();
+
 private:
 	void appendToResult(const char *nextBegin);
 	bool logError(const QString &text);
@@ -62,6 +58,7 @@ private:
 	QString _currentTagReplacer;
 
 	bool _failed = true;
+	bool _collect = true;
 
 	const char *_begin = nullptr;
 	const char *_ch = nullptr;
@@ -85,7 +82,9 @@ ValueParser::ValueParser(
 }
 
 void ValueParser::appendToResult(const char *nextBegin) {
-	if (_ch > _begin) _result.append(QString::fromUtf8(_begin, _ch - _begin));
+	if (_collect && _ch > _begin) {
+		_result.append(QString::fromUtf8(_begin, _ch - _begin));
+	}
 	_begin = nextBegin;
 }
 
@@ -132,7 +131,9 @@ bool ValueParser::readTag() {
 	}
 	_tagsUsed.insert(_currentTagIndex);
 
-	if (_currentTagReplacer.isEmpty()) {
+	if (!_collect) {
+		return true;
+	} else if (_currentTagReplacer.isEmpty()) {
 		_currentTagReplacer = QString(4, QChar(kTextCommand));
 		_currentTagReplacer[1] = QChar(kTextCommandLangTag);
 	}
@@ -143,7 +144,9 @@ bool ValueParser::readTag() {
 
 bool ValueParser::parse() {
 	_failed = false;
-	_result.reserve(_end - _begin);
+	if (_collect) {
+		_result.reserve(_end - _begin);
+	}
 	for (; _ch != _end; ++_ch) {
 		if (*_ch == '{') {
 			appendToResult(_ch);
@@ -153,7 +156,9 @@ bool ValueParser::parse() {
 				return false;
 			}
 
-			_result.append(_currentTagReplacer);
+			if (_collect) {
+				_result.append(_currentTagReplacer);
+			}
 
 			_begin = _ch + 1;
 			_currentTag = QLatin1String("");
@@ -163,6 +168,11 @@ bool ValueParser::parse() {
 	return true;
 }
 
+bool ValueParser::validate() {
+	_collect = false;
+	return parse();
+}
+
 QString PrepareTestValue(const QString &current, QChar filler) {
 	auto size = current.size();
 	auto result = QString(size + 1, filler);
@@ -235,8 +245,49 @@ Language DefaultLanguage() {
 struct Instance::PrivateTag {
 };
 
+class Instance::Value final {
+public:
+	Value(QByteArray key, ushort index, QByteArray value);
+	explicit Value(QString text);
+
+	[[nodiscard]] QString text() const;
+
+private:
+	const QByteArray _key;
+	const QByteArray _value;
+	const ushort _index = kKeysCount;
+	const bool _decoded = false;
+	mutable std::once_flag _decode;
+	mutable QString _text;
+
+};
+
+Instance::Value::Value(QByteArray key, ushort index, QByteArray value)
+: _key(std::move(key))
+, _value(std::move(value))
+, _index(index) {
+}
+
+Instance::Value::Value(QString text)
+: _decoded(true)
+, _text(std::move(text)) {
+}
+
+QString Instance::Value::text() const {
+	if (!_decoded) {
+		std::call_once(_decode, [&] {
+			// The value was validated when it was applied.
+			auto parser = ValueParser(_key, _index, _value);
+			_text = parser.parse()
+				? parser.takeResult()
+				: GetOriginalValue(_index);
+		});
+	}
+	return _text;
+}
+
 Instance::Instance()
-: _values(PrepareDefaultValues())
+: _values(kKeysCount)
 , _nonDefaultSet(kKeysCount, 0) {
 }
 
@@ -248,8 +299,9 @@ Instance::Instance(not_null<Instance*> derived, const PrivateTag &)
 void Instance::switchToId(const Language &data) {
 	reset(data);
 	if (_id == u"#TEST_X"_q || _id == u"#TEST_0"_q) {
-		for (auto &value : _values) {
-			value = PrepareTestValue(value, _id[5]);
+		for (auto i = 0, count = int(_values.size()); i != count; ++i) {
+			setValue(ushort(i), std::make_shared<Value>(
+				PrepareTestValue(GetOriginalValue(ushort(i)), _id[5])));
 		}
 		if (!_derived) {
 			_updated.fire({});
@@ -293,10 +345,8 @@ void Instance::reset(const Language &data) {
 	_customFileContent = QByteArray();
 	_version = 0;
 	_nonDefaultValues.clear();
-	for (auto i = 0, count = int(_values.size()); i != count; ++i) {
-		_values[i] = GetOriginalValue(ushort(i));
-	}
 	ranges::fill(_nonDefaultSet, 0);
+	resetValuesToDefault();
 	updateChoosingStickerReplacement();
 
 	_idChanges.fire_copy(_id);
@@ -726,24 +776,57 @@ QString Instance::getNonDefaultValue(const QByteArray &key) const {
 		: QString();
 }
 
+QString Instance::getValue(ushort key) const {
+	Expects(key < _values.size());
+
+	auto value = std::shared_ptr<const Value>();
+	{
+		QReadLocker lock(&_valuesLock);
+		value = _values[key];
+	}
+	return value ? value->text() : GetOriginalValue(key);
+}
+
 void Instance::applyValue(const QByteArray &key, const QByteArray &value) {
 	_nonDefaultValues[key] = value;
-	ParseKeyValue(key, value, [&](ushort key, QString &&value) {
-		_nonDefaultSet[key] = 1;
-		if (!_derived) {
-			_values[key] = std::move(value);
-		} else if (!_derived->_nonDefaultSet[key]) {
-			_derived->_values[key] = std::move(value);
+
+	// The value is only checked here, it is decoded in getValue().
+	const auto index = GetKeyIndex(QLatin1String(key));
+	if (index == kKeysCount) {
+		if (!key.startsWith("cloud_")) {
+			DEBUG_LOG(("Lang Warning: Unknown key '%1'"
+				).arg(QString::fromLatin1(key)));
 		}
-		if (key == tr::lng_send_action_choose_sticker.base
-			|| key == tr::lng_user_action_choose_sticker.base) {
-			if (!_derived) {
-				updateChoosingStickerReplacement();
-			} else {
-				_derived->updateChoosingStickerReplacement();
-			}
+		return;
+	} else if (!ValueParser(key, index, value).validate()) {
+		return;
+	}
+	_nonDefaultSet[index] = 1;
+	if (!_derived) {
+		setValue(index, std::make_shared<Value>(key, index, value));
+	} else if (!_derived->_nonDefaultSet[index]) {
+		_derived->setValue(
+			index,
+			std::make_shared<Value>(key, index, value));
+	}
+	if (index == tr::lng_send_action_choose_sticker.base
+		|| index == tr::lng_user_action_choose_sticker.base) {
+		if (!_derived) {
+			updateChoosingStickerReplacement();
+		} else {
+			_derived->updateChoosingStickerReplacement();
 		}
-	});
+	}
+}
+
+void Instance::setValue(ushort key, std::shared_ptr<const Value> value) {
+	QWriteLocker lock(&_valuesLock);
+	_values[key] = std::move(value);
+}
+
+void Instance::resetValuesToDefault() {
+	QWriteLocker lock(&_valuesLock);
+	ranges::fill(_values, nullptr);
 }
 
 void Instance::updatePluralRules() {
@@ -764,14 +847,17 @@ void Instance::resetValue(const QByteArray &key) {
 	if (keyIndex != kKeysCount) {
 		_nonDefaultSet[keyIndex] = 0;
 		if (!_derived) {
-			const auto base = _base
-				? _base->getNonDefaultValue(key)
-				: QString();
-			_values[keyIndex] = !base.isEmpty()
-				? base
-				: GetOriginalValue(keyIndex);
+			auto value = std::shared_ptr<const Value>();
+			if (_base && _base->_nonDefaultSet[keyIndex]) {
+				const auto &values = _base->_nonDefaultValues;
+				const auto i = values.find(key);
+				if (i != end(values)) {
+					value = std::make_shared<Value>(key, keyIndex, i->second);
+				}
+			}
+			setValue(keyIndex, std::move(value));
 		} else if (!_derived->_nonDefaultSet[keyIndex]) {
-			_derived->_values[keyIndex] = GetOriginalValue(keyIndex);
+			_derived->setValue(keyIndex, nullptr);
 		}
 		if (keyIndex == tr::lng_send_action_choose_sticker.base
 			|| keyIndex == tr::lng_user_action_choose_sticker.base) {
@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/const_string.h"
 #include "base/weak_ptr.h"
 
+#include <QtCore/QReadWriteLock>
+
 namespace Lang {
 
 inline constexpr auto kChoosingStickerReplacement = "oo"_cs;
@@ -87,11 +89,7 @@ public:
 		return _updated.events();
 	}
 
-	QString getValue(ushort key) const {
-		Expects(key < _values.size());
-
-		return _values[key];
-	}
+	[[nodiscard]] QString getValue(ushort key) const;
 	QString getNonDefaultValue(const QByteArray &key) const;
 	bool isNonDefaultPlural(ushort key) const {
 		Expects(key + 5 < _nonDefaultSet.size());
@@ -125,6 +123,10 @@ private:
 	void updatePluralRules();
 	void updateChoosingStickerReplacement();
 
+	class Value;
+	void setValue(ushort key, std::shared_ptr<const Value> value);
+	void resetValuesToDefault();
+
 	Instance *_derived = nullptr;
 
 	QString _id, _pluralId;
@@ -144,7 +146,11 @@ private:
 
 	mutable QString _systemLanguage;
 
-	std::vector<QString> _values;
+	// Pack values are kept in UTF-8 and decoded on first access, empty
+	// values are the built-in ones. Translations are requested from any
+	// thread, so the slots are replaced only under the lock.
+	std::vector<std::shared_ptr<const Value>> _values;
+	mutable QReadWriteLock _valuesLock;
 	std::vector<uchar> _nonDefaultSet;
 	std::map<QByteArray, QByteArray> _nonDefaultValues;
 
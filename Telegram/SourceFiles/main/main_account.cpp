@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_account.h"
 
 #include "base/platform/base_platform_info.h"
+#include "base/timer.h"
 #include "core/application.h"
 #include "storage/storage_account.h"
 #include "storage/storage_domain.h" // Storage::StartResult.
@@ -32,6 +33,7 @@ namespace Main {
 namespace {
 
 constexpr auto kWideIdsTag = ~uint64(0);
+constexpr auto kWriteEndpointRttsDelay = 10 * crl::time(1000);
 
 [[nodiscard]] QString ComposeDataString(const QString &dataName, int index) {
 	auto result = dataName;
@@ -449,6 +451,16 @@ void Account::startMtp(std::unique_ptr<MTP::Config> config) {
 		});
 	}, _lifetime);
 
+	// Learned connect times are saved with the config, not too often.
+	const auto writeEndpointRtts = _mtp->lifetime().make_state<base::Timer>(
+		[=] { local().writeMtpConfig(); });
+	_mtp->dcOptions().endpointRttsChanged(
+	) | rpl::filter([=] {
+		return !writeEndpointRtts->isActive();
+	}) | rpl::start_with_next([=] {
+		writeEndpointRtts->callOnce(kWriteEndpointRttsDelay);
+	}, _mtp->lifetime());
+
 	_mtpFields.mainDcId = _mtp->mainDcId();
 
 	_mtp->setUpdatesHandler([=](const MTP::Response &message) {
@@ -66,7 +66,21 @@ bool Domain::started() const {
 Storage::StartResult Domain::start(const QByteArray &passcode) {
 	Expects(!started());
 
-	const auto result = _local->start(passcode);
+	return startFinished(_local->start(passcode));
+}
+
+void Domain::startAsync(
+		const QByteArray &passcode,
+		Fn<void(Storage::StartResult)> done) {
+	Expects(!started());
+
+	_local->startAsync(passcode, crl::guard(this, [=](
+			Storage::StartResult result) {
+		done(startFinished(result));
+	}));
+}
+
+Storage::StartResult Domain::startFinished(Storage::StartResult result) {
 	if (result == Storage::StartResult::Success) {
 		activateAfterStarting();
 		crl::on_main(&Core::App(), [=] { suggestExportIfNeeded(); });
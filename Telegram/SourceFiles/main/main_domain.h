@@ -39,6 +39,9 @@ public:
 
 	[[nodiscard]] bool started() const;
 	[[nodiscard]] Storage::StartResult start(const QByteArray &passcode);
+	void startAsync(
+		const QByteArray &passcode,
+		Fn<void(Storage::StartResult)> done);
 	void resetWithForgottenPasscode();
 	void finish();
 
@@ -81,6 +84,7 @@ public:
 
 private:
 	void activateAfterStarting();
+	Storage::StartResult startFinished(Storage::StartResult result);
 	void closeAccountWindows(not_null<Main::Account*> account);
 	bool removePasscodeIfEmpty();
 	void removeRedundantAccounts();
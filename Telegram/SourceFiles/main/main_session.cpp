@@ -49,6 +49,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "support/support_helper.h"
 #include "lang/lang_keys.h"
 #include "core/application.h"
+#include "core/startup_trace.h"
 #include "ui/text/text_utilities.h"
 #include "ui/layers/generic_box.h"
 #include "styles/style_layers.h"
@@ -180,6 +181,8 @@ Session::Session(
 
 		// Storage::Account uses Main::Account::session() in those methods.
 		// So they can't be called during Main::Session construction.
+		const auto trace = Core::StartupTrace::Span("Session::readStickers");
+		local().preloadStickerSets();
 		local().readInstalledStickers();
 		local().readInstalledMasks();
 		local().readInstalledCustomEmoji();
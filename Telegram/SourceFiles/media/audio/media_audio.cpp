@@ -238,6 +238,7 @@ constexpr auto kFadeDuration = crl::time(500);
 constexpr auto kCheckPlaybackPositionTimeout = crl::time(100); // 100ms per check audio position
 constexpr auto kCheckPlaybackPositionDelta = 2400LL; // update position called each 2400 samples
 constexpr auto kCheckFadingTimeout = crl::time(7); // 7ms
+constexpr auto kCheckBackgroundTimeout = crl::time(1000);
 
 rpl::event_stream<AudioMsgId> UpdatedStream;
 
@@ -485,6 +486,13 @@ Mixer::Mixer(not_null<Audio::Instance*> instance)
 		});
 	}, _lifetime);
 
+	Core::App().appDeactivatedValue(
+	) | rpl::start_with_next([=](bool deactivated) {
+		InvokeQueued(_fader, [fader = _fader, deactivated] {
+			fader->setInBackground(deactivated);
+		});
+	}, _lifetime);
+
 	connect(this, SIGNAL(loaderOnStart(AudioMsgId,qint64)), _loader, SLOT(onStart(AudioMsgId,qint64)));
 	connect(this, SIGNAL(loaderOnCancel(AudioMsgId)), _loader, SLOT(onCancel(AudioMsgId)), Qt::QueuedConnection);
 	connect(_loader, SIGNAL(needToCheck()), _fader, SLOT(onTimer()));
@@ -1104,6 +1112,14 @@ void Fader::onTimer() {
 
 	constexpr auto kMediaPlayerSuppressDuration = crl::time(150);
 
+	countWakeup();
+
+	// Sleep until the nearest fade step, buffer refill or position update.
+	auto nextCheck = crl::time(-1);
+	const auto checkIn = [&](crl::time delay) {
+		nextCheck = (nextCheck < 0) ? delay : std::min(nextCheck, delay);
+	};
+
 	auto volumeChangedAll = false;
 	auto volumeChangedSong = false;
 	if (_suppressAll || _suppressSongAnim) {
@@ -1115,13 +1131,20 @@ void Fader::onTimer() {
 			} else if (ms > _suppressAllEnd - kFadeDuration) {
 				if (_suppressVolumeAll.to() != 1.) _suppressVolumeAll.start(1.);
 				_suppressVolumeAll.update(1. - ((_suppressAllEnd - ms) / float64(kFadeDuration)), anim::linear);
+				checkIn(kCheckFadingTimeout);
 			} else if (ms >= _suppressAllStart + kMediaPlayerSuppressDuration) {
 				if (_suppressAllAnim) {
 					_suppressVolumeAll.finish();
 					_suppressAllAnim = false;
 				}
-			} else if (ms > _suppressAllStart) {
-				_suppressVolumeAll.update((ms - _suppressAllStart) / float64(kMediaPlayerSuppressDuration), anim::linear);
+				checkIn(std::max(
+					_suppressAllEnd - kFadeDuration - ms,
+					kCheckFadingTimeout));
+			} else {
+				if (ms > _suppressAllStart) {
+					_suppressVolumeAll.update((ms - _suppressAllStart) / float64(kMediaPlayerSuppressDuration), anim::linear);
+				}
+				checkIn(kCheckFadingTimeout);
 			}
 			auto wasVolumeMultiplierAll = VolumeMultiplierAll;
 			VolumeMultiplierAll = _suppressVolumeAll.current();
@@ -1133,6 +1156,7 @@ void Fader::onTimer() {
 				_suppressSongAnim = false;
 			} else {
 				_suppressVolumeSong.update((ms - _suppressSongStart) / float64(kFadeDuration), anim::linear);
+				checkIn(kCheckFadingTimeout);
 			}
 		}
 		auto wasVolumeMultiplierSong = VolumeMultiplierSong;
@@ -1140,14 +1164,18 @@ void Fader::onTimer() {
 		accumulate_min(VolumeMultiplierSong, VolumeMultiplierAll);
 		volumeChangedSong = (VolumeMultiplierSong != wasVolumeMultiplierSong);
 	}
-	auto hasFading = (_suppressAll || _suppressSongAnim);
-	auto hasPlaying = false;
-
-	auto updatePlayback = [this, &hasPlaying, &hasFading](AudioMsgId::Type type, int index, float64 volumeMultiplier, bool suppressGainChanged) {
+	auto updatePlayback = [&](AudioMsgId::Type type, int index, float64 volumeMultiplier, bool suppressGainChanged) {
 		auto track = mixer()->trackForType(type, index);
 		if (IsStopped(track->state.state) || track->state.state == State::Paused || !track->isStreamCreated()) return;
 
-		auto emitSignals = updateOnePlayback(track, hasPlaying, hasFading, volumeMultiplier, suppressGainChanged);
+		auto playing = false;
+		auto fading = false;
+		auto emitSignals = updateOnePlayback(track, playing, fading, volumeMultiplier, suppressGainChanged);
+		if (fading) {
+			checkIn(kCheckFadingTimeout);
+		} else if (playing) {
+			checkIn(playbackCheckDelay(track));
+		}
 		if (emitSignals & EmitError) error(track->state.id);
 		if (emitSignals & EmitStopped) audioStopped(track->state.id);
 		if (emitSignals & EmitPositionUpdated) playPositionUpdated(track->state.id);
@@ -1166,17 +1194,74 @@ void Fader::onTimer() {
 
 	_volumeChangedSong = _volumeChangedVideo = false;
 
-	if (hasFading) {
-		_timer.start(kCheckFadingTimeout);
-		Audio::StopDetachIfNotUsedSafe();
-	} else if (hasPlaying) {
-		_timer.start(kCheckPlaybackPositionTimeout);
+	if (nextCheck >= 0) {
+		_timer.start(nextCheck);
 		Audio::StopDetachIfNotUsedSafe();
 	} else {
+		_timer.stop();
 		Audio::ScheduleDetachIfNotUsedSafe();
 	}
 }
 
+crl::time Fader::playbackCheckDelay(
+		not_null<const Mixer::Track*> track) const {
+	// Video tracks sync frames with their position, the other positions
+	// are shown in the interface and are not needed in the background.
+	const auto limit = (_inBackground
+		&& track->state.id.type() != AudioMsgId::Type::Video)
+		? kCheckBackgroundTimeout
+		: kCheckPlaybackPositionTimeout;
+	const auto frequency = int64(track->state.frequency);
+	const auto &speed = track->withSpeed;
+	const auto left = speed.bufferedPosition
+		+ speed.bufferedLength
+		- speed.fineTunedPosition;
+	if (frequency <= 0 || left <= 0) {
+		// Loaders::loadData() calls us when the source is restarted.
+		return kCheckPlaybackPositionTimeout;
+	}
+	auto samples = left;
+	if ((!track->loaded && !track->loading) || track->waitingForBuffer) {
+		const auto preload = kPreloadSeconds * frequency;
+		if (left <= preload) {
+			// The loader waits for us to ask for more data.
+			return kCheckPlaybackPositionTimeout;
+		}
+		samples = left - preload;
+	}
+	return std::clamp(
+		samples * crl::time(1000) / frequency,
+		kCheckFadingTimeout,
+		limit);
+}
+
+void Fader::countWakeup() {
+	const auto now = crl::now();
+	++_wakeups;
+	if (!_wakeupsStart) {
+		_wakeupsStart = now;
+		return;
+	} else if (now - _wakeupsStart < crl::time(1000)) {
+		return;
+	}
+	const auto perSecond = int(_wakeups * crl::time(1000)
+		/ (now - _wakeupsStart));
+	if (_wakeupsPerSecond != perSecond) {
+		_wakeupsPerSecond = perSecond;
+		DEBUG_LOG(("Audio Info: Fader wakeups per second %1."
+			).arg(perSecond));
+	}
+	_wakeupsStart = now;
+	_wakeups = 0;
+}
+
+void Fader::setInBackground(bool inBackground) {
+	if (_inBackground != inBackground) {
+		_inBackground = inBackground;
+		onTimer();
+	}
+}
+
 int32 Fader::updateOnePlayback(Mixer::Track *track, bool &hasPlaying, bool &hasFading, float64 volumeMultiplier, bool volumeChanged) {
 	const auto errorHappened = [&] {
 		if (Audio::PlaybackErrorHappened()) {
@@ -329,6 +329,7 @@ public:
 
 	void songVolumeChanged();
 	void videoVolumeChanged();
+	void setInBackground(bool inBackground);
 
 Q_SIGNALS:
 	void error(const AudioMsgId &audio);
@@ -353,8 +354,16 @@ private:
 	};
 	int32 updateOnePlayback(Mixer::Track *track, bool &hasPlaying, bool &hasFading, float64 volumeMultiplier, bool volumeChanged);
 	void setStoppedState(Mixer::Track *track, State state = State::Stopped);
+	[[nodiscard]] crl::time playbackCheckDelay(
+		not_null<const Mixer::Track*> track) const;
+	void countWakeup();
 
 	QTimer _timer;
+	bool _inBackground = false;
+
+	crl::time _wakeupsStart = 0;
+	int _wakeups = 0;
+	int _wakeupsPerSecond = 0;
 
 	bool _volumeChangedSong = false;
 	bool _volumeChangedVideo = false;
@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_file_origin.h"
 #include "main/main_session.h"
 #include "storage/file_download.h" // Storage::kMaxFileInMemory.
+#include "storage/storage_cache_write_back.h"
 #include "styles/style_widgets.h"
 
 #include <QtCore/QBuffer>
@@ -310,6 +311,7 @@ void Document::validateGoodThumbnail() {
 	const auto information = _info.video;
 	const auto key = document->goodThumbnailCacheKey();
 	const auto guard = base::make_weak(&document->session());
+	document->owner().cacheWriteBack().flush(key);
 	document->owner().cache().get(key, [=](QByteArray value) {
 		if (!value.isEmpty()) {
 			return;
@@ -342,17 +344,17 @@ void Document::validateGoodThumbnail() {
 			LOG(("App Error: Bad thumbnail data for saving to cache."));
 			bytes = "(failed)"_q;
 		}
-		crl::on_main(guard, [=] {
+		crl::on_main(guard, [=, bytes = std::move(bytes)]() mutable {
 			if (const auto active = document->activeMediaView()) {
 				active->setGoodThumbnail(image);
 			}
 			if (bytes != "(failed)"_q) {
 				document->setGoodThumbnailChecked(true);
 			}
-			document->owner().cache().putIfEmpty(
+			document->owner().cacheWriteBack().putIfEmpty(
 				document->goodThumbnailCacheKey(),
 				Storage::Cache::Database::TaggedValue(
-					base::duplicate(bytes),
+					std::move(bytes),
 					Data::kImageCacheTag));
 		});
 	});
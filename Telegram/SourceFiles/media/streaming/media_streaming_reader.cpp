@@ -341,7 +341,8 @@ auto Reader::Slice::offsetsFromLoader(uint32 from, uint32 till) const
 }
 
 Reader::Slices::Slices(uint32 size, bool useCache)
-: _size(size) {
+: _size(size)
+, _slicesLimit(kSlicesInMemory) {
 	Expects(size > 0);
 
 	if (useCache) {
@@ -397,6 +398,21 @@ bool Reader::Slices::fullInCache() const {
 	return _fullInCache;
 }
 
+int64 Reader::Slices::memoryUsage() const {
+	// Header parts share bytes with slice parts, so it is an estimate.
+	auto result = int64(_header.parts.size());
+	for (const auto &slice : _data) {
+		result += slice.parts.size();
+	}
+	return result * kPartSize;
+}
+
+void Reader::Slices::setSlicesLimit(int limit) {
+	Expects(limit >= 0);
+
+	_slicesLimit = limit;
+}
+
 int Reader::Slices::requestSliceSizesCount() const {
 	if (!headerModeUnknown() || isFullInHeader()) {
 		return 0;
@@ -724,12 +740,13 @@ Reader::SerializedSlice Reader::Slices::serializeAndUnloadUnused() {
 	using Flag = Slice::Flag;
 
 	if (_headerMode == HeaderMode::Unknown
-		|| _usedSlices.size() <= kSlicesInMemory) {
+		|| int(_usedSlices.size()) <= _slicesLimit) {
 		return {};
 	}
 	const auto purgeSlice = _usedSlices.front();
 	_usedSlices.pop_front();
-	if (!(_data[purgeSlice].flags & Flag::LoadedFromCache)) {
+	if (_headerMode != HeaderMode::NoCache
+		&& !(_data[purgeSlice].flags & Flag::LoadedFromCache)) {
 		// If the only data in this slice was from _header, just leave it.
 		return {};
 	}
@@ -779,7 +796,10 @@ Reader::SerializedSlice Reader::Slices::serializeAndUnloadSlice(
 		? 0
 		: FindNotLoadedStart(slice.parts, 0);
 	const auto continuous = (continuousTill > slice.parts.back().first);
-	if (continuous) {
+	if (continuous && count == 1) {
+		// Share the single part buffer instead of copying it.
+		result.data = slice.parts.front().second;
+	} else if (continuous) {
 		// All data is continuous.
 		result.data.reserve(count * kPartSize);
 		for (const auto &[offset, part] : slice.parts) {
@@ -849,13 +869,26 @@ Reader::SerializedSlice Reader::Slices::unloadToCache() {
 	return {};
 }
 
+auto Reader::Slices::unloadOverLimit() -> std::vector<SerializedSlice> {
+	auto result = std::vector<SerializedSlice>();
+	while (_headerMode != HeaderMode::Unknown
+		&& int(_usedSlices.size()) > _slicesLimit) {
+		auto slice = serializeAndUnloadUnused();
+		if (slice.number >= 0) {
+			result.push_back(std::move(slice));
+		}
+	}
+	return result;
+}
+
 Reader::Reader(
 	std::unique_ptr<Loader> loader,
 	Storage::Cache::Database *cache)
 : _loader(std::move(loader))
 , _cache(cache)
 , _cacheHelper(cache ? InitCacheHelper(_loader->baseCacheKey()) : nullptr)
-, _slices(_loader->size(), _cacheHelper != nullptr) {
+, _slices(_loader->size(), _cacheHelper != nullptr)
+, _slicesBudget([=] { crl::on_main(this, [=] { unloadIdleSlices(); }); }) {
 	_loader->parts(
 	) | rpl::start_with_next([=](LoadedPart &&part) {
 		if (_attachedDownloader) {
@@ -1124,6 +1157,19 @@ void Reader::setLoaderPriority(int priority) {
 
 void Reader::refreshLoaderPriority() {
 	_loader->setPriority(_streamingActive ? _realPriority : 0);
+	_slicesBudget.setPriority(_streamingActive ? (_realPriority + 1) : 0);
+}
+
+void Reader::unloadIdleSlices() {
+	if (_streamingActive || !_slicesBudget.limited()) {
+		// Active readers unload slices on the streaming thread.
+		return;
+	}
+	_slices.setSlicesLimit(0);
+	for (auto &slice : _slices.unloadOverLimit()) {
+		putToCache(std::move(slice));
+	}
+	_slicesBudget.used(_slices.memoryUsage());
 }
 
 bool Reader::isRemoteLoader() const {
@@ -1277,7 +1323,9 @@ Reader::FillState Reader::fill(
 Reader::FillState Reader::fillFromSlices(uint32 offset, bytes::span buffer) {
 	using namespace rpl::mappers;
 
+	_slices.setSlicesLimit(_slicesBudget.limited() ? 1 : kSlicesInMemory);
 	auto result = _slices.fill(offset, buffer);
+	_slicesBudget.used(_slices.memoryUsage());
 	if (result.state != FillState::Success && _slices.headerWontBeFilled()) {
 		_streamingError = Error::NotStreamable;
 		return FillState::Failed;
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "media/streaming/media_streaming_common.h"
 #include "media/streaming/media_streaming_loader.h"
+#include "media/streaming/media_streaming_slices_budget.h"
 #include "base/bytes.h"
 #include "base/weak_ptr.h"
 #include "base/thread_safe_wrap.h"
@@ -160,6 +161,8 @@ private:
 		[[nodiscard]] bool waitingForHeaderCache() const;
 
 		[[nodiscard]] int requestSliceSizesCount() const;
+		[[nodiscard]] int64 memoryUsage() const;
+		void setSlicesLimit(int limit);
 
 		void processCacheResult(int sliceNumber, PartsMap &&result);
 		void processCachedSizes(const std::vector<int> &sizes);
@@ -167,6 +170,7 @@ private:
 
 		[[nodiscard]] FillResult fill(uint32 offset, bytes::span buffer);
 		[[nodiscard]] SerializedSlice unloadToCache();
+		[[nodiscard]] std::vector<SerializedSlice> unloadOverLimit();
 
 		[[nodiscard]] QByteArray partForDownloader(uint32 offset) const;
 		[[nodiscard]] bool readCacheForDownloaderRequired(uint32 offset);
@@ -201,6 +205,7 @@ private:
 		Slice _header;
 		std::deque<int> _usedSlices;
 		uint32 _size = 0;
+		int _slicesLimit = 0;
 		HeaderMode _headerMode = HeaderMode::Unknown;
 		bool _fullInCache = false;
 
@@ -235,6 +240,7 @@ private:
 	void checkForDownloaderReadyOffsets();
 
 	void refreshLoaderPriority();
+	void unloadIdleSlices();
 
 	static std::shared_ptr<CacheHelper> InitCacheHelper(
 		Storage::Cache::Key baseKey);
@@ -252,6 +258,7 @@ private:
 	PriorityQueue _loadingOffsets;
 
 	Slices _slices;
+	SlicesBudget _slicesBudget;
 
 	// Even if streaming had failed, the Reader can work for the downloader.
 	std::optional<Error> _streamingError;
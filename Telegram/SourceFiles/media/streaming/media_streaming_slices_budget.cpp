@@ -0,0 +1,154 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "media/streaming/media_streaming_slices_budget.h"
+
+#include <QtCore/QMutex>
+
+namespace Media {
+namespace Streaming {
+namespace {
+
+constexpr auto kSlicesMemoryLimit = int64(32 * 1024 * 1024);
+
+} // namespace
+
+class SlicesBudgetRegistry final {
+public:
+	static void Add(not_null<SlicesBudget*> budget);
+	static void Remove(not_null<SlicesBudget*> budget);
+	static void Changed(int64 delta);
+	static void Rebalance();
+	[[nodiscard]] static SlicesMemoryStats Stats();
+
+private:
+	struct Data {
+		QMutex mutex;
+		std::vector<not_null<SlicesBudget*>> list;
+		std::atomic<int64> total = 0;
+		std::atomic<int> limited = 0;
+	};
+
+	[[nodiscard]] static Data &Instance();
+	static void RebalanceLocked(Data &data);
+
+};
+
+auto SlicesBudgetRegistry::Instance() -> Data & {
+	static auto result = Data();
+	return result;
+}
+
+void SlicesBudgetRegistry::Add(not_null<SlicesBudget*> budget) {
+	auto &data = Instance();
+	QMutexLocker lock(&data.mutex);
+	data.list.push_back(budget);
+}
+
+void SlicesBudgetRegistry::Remove(not_null<SlicesBudget*> budget) {
+	auto &data = Instance();
+	QMutexLocker lock(&data.mutex);
+	data.list.erase(ranges::remove(data.list, budget), end(data.list));
+	data.total -= budget->_bytes.load();
+	RebalanceLocked(data);
+}
+
+void SlicesBudgetRegistry::Changed(int64 delta) {
+	auto &data = Instance();
+	const auto total = (data.total += delta);
+	if (total > kSlicesMemoryLimit || data.limited.load() > 0) {
+		Rebalance();
+	}
+}
+
+void SlicesBudgetRegistry::Rebalance() {
+	auto &data = Instance();
+	QMutexLocker lock(&data.mutex);
+	RebalanceLocked(data);
+}
+
+void SlicesBudgetRegistry::RebalanceLocked(Data &data) {
+	auto sorted = data.list;
+	ranges::sort(sorted, ranges::greater(), [](not_null<SlicesBudget*> b) {
+		return std::make_pair(b->_priority.load(), b->_lastUsed.load());
+	});
+	auto left = kSlicesMemoryLimit;
+	auto limited = 0;
+	auto first = true;
+	for (const auto budget : sorted) {
+		const auto bytes = budget->_bytes.load();
+		const auto wasLimited = budget->_limited.load();
+
+		// A limited reader will use about twice as much when released.
+		const auto required = wasLimited ? (bytes * 2) : bytes;
+		if (base::take(first) || required <= left) {
+			left -= bytes;
+			if (wasLimited) {
+				budget->_limited = false;
+				DEBUG_LOG(("Streaming Info: "
+					"Slices limit removed, %1 bytes in use."
+					).arg(bytes));
+			}
+		} else {
+			++limited;
+			if (!wasLimited) {
+				budget->_limited = true;
+				DEBUG_LOG(("Streaming Info: "
+					"Slices limited, %1 bytes in use, %2 bytes left."
+					).arg(bytes
+					).arg(left));
+				budget->_limitedCallback();
+			}
+		}
+	}
+	data.limited = limited;
+}
+
+SlicesMemoryStats SlicesBudgetRegistry::Stats() {
+	auto &data = Instance();
+	QMutexLocker lock(&data.mutex);
+	return {
+		.readers = int(data.list.size()),
+		.limited = data.limited.load(),
+		.bytes = data.total.load(),
+		.limit = kSlicesMemoryLimit,
+	};
+}
+
+SlicesBudget::SlicesBudget(Fn<void()> limitedCallback)
+: _limitedCallback(std::move(limitedCallback)) {
+	SlicesBudgetRegistry::Add(this);
+}
+
+SlicesBudget::~SlicesBudget() {
+	SlicesBudgetRegistry::Remove(this);
+}
+
+void SlicesBudget::setPriority(int priority) {
+	if (_priority.exchange(priority) != priority) {
+		SlicesBudgetRegistry::Changed(0);
+	}
+}
+
+void SlicesBudget::used(int64 bytes) {
+	_lastUsed = crl::now();
+	const auto was = _bytes.exchange(bytes);
+	if (was != bytes) {
+		SlicesBudgetRegistry::Changed(bytes - was);
+	}
+}
+
+bool SlicesBudget::limited() const {
+	return _limited.load();
+}
+
+SlicesMemoryStats CollectSlicesMemoryStats() {
+	return SlicesBudgetRegistry::Stats();
+}
+
+} // namespace Streaming
+} // namespace Media
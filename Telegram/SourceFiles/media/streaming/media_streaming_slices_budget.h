@@ -0,0 +1,56 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Media {
+namespace Streaming {
+
+struct SlicesMemoryStats {
+	int readers = 0;
+	int limited = 0;
+	int64 bytes = 0;
+	int64 limit = 0;
+};
+
+// One memory limit for the loaded slices of all readers.
+//
+// Readers are ordered by priority (active and visible players first)
+// and then by the time they were read from last. Readers that don't
+// fit in the limit are asked to keep fewer slices in memory.
+class SlicesBudget final {
+public:
+	// The callback is called from any thread when the reader is limited.
+	explicit SlicesBudget(Fn<void()> limitedCallback);
+	SlicesBudget(const SlicesBudget &other) = delete;
+	SlicesBudget &operator=(const SlicesBudget &other) = delete;
+	~SlicesBudget();
+
+	// Main thread.
+	void setPriority(int priority);
+
+	// Thread that works with the reader slices.
+	void used(int64 bytes);
+
+	// Thread safe.
+	[[nodiscard]] bool limited() const;
+
+private:
+	friend class SlicesBudgetRegistry;
+
+	const Fn<void()> _limitedCallback;
+	std::atomic<int64> _bytes = 0;
+	std::atomic<crl::time> _lastUsed = 0;
+	std::atomic<int> _priority = 0;
+	std::atomic<bool> _limited = false;
+
+};
+
+[[nodiscard]] SlicesMemoryStats CollectSlicesMemoryStats();
+
+} // namespace Streaming
+} // namespace Media
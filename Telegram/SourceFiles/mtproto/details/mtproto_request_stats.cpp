@@ -0,0 +1,179 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/details/mtproto_request_stats.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+#include <array>
+#include <atomic>
+#include <bit>
+
+namespace MTP::details {
+namespace {
+
+constexpr auto kSlotsCount = 512;
+
+// Each power of two is split into kSubBuckets linear sub-buckets, so any
+// reported value is within 1/kSubBuckets of the recorded one.
+constexpr auto kSubBucketBits = 3;
+constexpr auto kSubBuckets = (1 << kSubBucketBits);
+constexpr auto kValueBits = 28;
+constexpr auto kMaxValue = (int64(1) << kValueBits) - 1;
+constexpr auto kBucketsCount = (kValueBits - kSubBucketBits + 1)
+	* kSubBuckets;
+
+// Values below kSubBuckets get a bucket each, larger values are bucketed
+// by their highest kSubBucketBits + 1 bits.
+[[nodiscard]] int BucketIndex(int64 value) {
+	const auto clamped = uint64(std::clamp(value, int64(0), kMaxValue));
+	if (clamped < kSubBuckets) {
+		return int(clamped);
+	}
+	const auto shift = int(std::bit_width(clamped)) - 1 - kSubBucketBits;
+	return (shift + 1) * kSubBuckets
+		+ int(clamped >> shift) - kSubBuckets;
+}
+
+[[nodiscard]] int64 BucketUpperBound(int index) {
+	if (index < kSubBuckets) {
+		return index;
+	}
+	const auto shift = (index / kSubBuckets) - 1;
+	const auto mantissa = kSubBuckets + (index % kSubBuckets);
+	return (int64(mantissa + 1) << shift) - 1;
+}
+
+struct Histogram {
+	std::array<std::atomic<uint32>, kBucketsCount> buckets = {};
+
+	void add(int64 value) {
+		buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	}
+	[[nodiscard]] int64 percentile(int percent) const {
+		auto total = uint64();
+		for (const auto &bucket : buckets) {
+			total += bucket.load(std::memory_order_relaxed);
+		}
+		const auto wanted = (total * percent + 99) / 100;
+		auto counted = uint64();
+		for (auto i = 0; i != kBucketsCount; ++i) {
+			counted += buckets[i].load(std::memory_order_relaxed);
+			if (counted >= wanted && counted > 0) {
+				return BucketUpperBound(i);
+			}
+		}
+		return 0;
+	}
+};
+
+struct Slot {
+	std::atomic<uint64> key = 0;
+	std::atomic<uint32> count = 0;
+	std::atomic<uint32> floodWaits = 0;
+	std::atomic<uint64> sentBytes = 0;
+	std::atomic<uint64> receivedBytes = 0;
+	std::atomic<uint64> unpackedBytes = 0;
+	Histogram latency;
+	Histogram sent;
+	Histogram received;
+};
+
+struct Table {
+	std::array<Slot, kSlotsCount> slots;
+	std::atomic<uint32> dropped = 0;
+};
+
+[[nodiscard]] Table &Stats() {
+	static auto result = Table();
+	return result;
+}
+
+[[nodiscard]] Slot *FindSlot(Table &table, uint64 key) {
+	const auto start = (key * 0x9E3779B97F4A7C15ULL) >> 55;
+	for (auto i = 0; i != kSlotsCount; ++i) {
+		auto &slot = table.slots[(start + i) % kSlotsCount];
+		auto existing = slot.key.load(std::memory_order_acquire);
+		if (!existing && slot.key.compare_exchange_strong(existing, key)) {
+			return &slot;
+		} else if (existing == key) {
+			// Failed exchange puts the claimed key to the 'existing'.
+			return &slot;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace
+
+void RecordRequestStats(const RequestStatsRecord &record) {
+	auto &table = Stats();
+	const auto key = (uint64(uint32(record.shiftedDcId)) << 32)
+		| uint64(uint32(record.methodId));
+	const auto slot = FindSlot(table, key);
+	if (!slot) {
+		table.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	constexpr auto relaxed = std::memory_order_relaxed;
+	slot->count.fetch_add(1, relaxed);
+	if (record.floodWait) {
+		slot->floodWaits.fetch_add(1, relaxed);
+	}
+	slot->sentBytes.fetch_add(record.sentBytes, relaxed);
+	slot->receivedBytes.fetch_add(record.receivedBytes, relaxed);
+	slot->unpackedBytes.fetch_add(record.unpackedBytes, relaxed);
+	slot->latency.add(record.latency);
+	slot->sent.add(record.sentBytes);
+	slot->received.add(record.receivedBytes);
+}
+
+bool DumpRequestStats(const QString &path) {
+	QFile f(path);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		return false;
+	}
+	QTextStream stream(&f);
+	stream
+		<< "dc\tmethod\tcount\t"
+		<< "rtt_p50\trtt_p90\trtt_p99\t"
+		<< "sent_p50\tsent_p99\treceived_p50\treceived_p99\t"
+		<< "gzip_ratio\tflood_waits\n";
+	const auto &table = Stats();
+	for (const auto &slot : table.slots) {
+		const auto key = slot.key.load(std::memory_order_acquire);
+		const auto count = slot.count.load();
+		if (!key || !count) {
+			continue;
+		}
+		const auto received = slot.receivedBytes.load();
+		const auto unpacked = slot.unpackedBytes.load();
+		const auto ratio = received
+			? (unpacked / double(received))
+			: 1.;
+		stream
+			<< (key >> 32) << '\t'
+			<< QString::number(uint32(key), 16) << '\t'
+			<< count << '\t'
+			<< slot.latency.percentile(50) << '\t'
+			<< slot.latency.percentile(90) << '\t'
+			<< slot.latency.percentile(99) << '\t'
+			<< slot.sent.percentile(50) << '\t'
+			<< slot.sent.percentile(99) << '\t'
+			<< slot.received.percentile(50) << '\t'
+			<< slot.received.percentile(99) << '\t'
+			<< QString::number(ratio, 'f', 2) << '\t'
+			<< slot.floodWaits.load() << '\n';
+	}
+	if (const auto dropped = table.dropped.load()) {
+		stream << "dropped\t" << dropped << '\n';
+	}
+	return true;
+}
+
+} // namespace MTP::details
@@ -0,0 +1,30 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "mtproto/core_types.h"
+
+namespace MTP::details {
+
+struct RequestStatsRecord {
+	ShiftedDcId shiftedDcId = 0;
+	mtpTypeId methodId = 0;
+	crl::time latency = 0;
+	int sentBytes = 0;
+	int receivedBytes = 0;
+	int unpackedBytes = 0;
+	bool floodWait = false;
+};
+
+// Thread safe and lock-free, called from the session threads.
+void RecordRequestStats(const RequestStatsRecord &record);
+
+// Writes per dc and method histograms as a plain text table.
+bool DumpRequestStats(const QString &path);
+
+} // namespace MTP::details
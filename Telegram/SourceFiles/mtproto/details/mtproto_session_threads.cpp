@@ -0,0 +1,140 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/details/mtproto_session_threads.h"
+
+#include "base/invoke_queued.h"
+
+namespace MTP::details {
+namespace {
+
+constexpr auto kRegularThreads = 2;
+
+[[nodiscard]] int FilesThreadsCount() {
+	return 2 * std::max(QThread::idealThreadCount() / 2, 1);
+}
+
+} // namespace
+
+class SessionThreads::Thread final : public QThread {
+public:
+	SessionThreadStats stats;
+
+};
+
+SessionThreads::SessionThreads()
+: _regular(kRegularThreads)
+, _files(FilesThreadsCount()) {
+}
+
+SessionThreads::~SessionThreads() {
+	const auto all = { &_regular, &_files };
+	for (const auto list : all) {
+		for (const auto &entry : *list) {
+			if (entry.thread) {
+				entry.thread->quit();
+			}
+		}
+	}
+	for (const auto list : all) {
+		for (const auto &entry : *list) {
+			if (entry.thread) {
+				entry.thread->wait();
+			}
+		}
+	}
+}
+
+std::shared_ptr<SessionThreads> SessionThreads::Instance() {
+	static auto Weak = std::weak_ptr<SessionThreads>();
+	if (auto result = Weak.lock()) {
+		return result;
+	}
+	auto result = std::make_shared<SessionThreads>();
+	Weak = result;
+	return result;
+}
+
+not_null<QThread*> SessionThreads::choose(Type type) {
+	return (type == Type::Files)
+		? choose(_files, "Files")
+		: choose(_regular, "Regular");
+}
+
+not_null<QThread*> SessionThreads::choose(
+		std::vector<Entry> &list,
+		const char *name) {
+	Expects(!list.empty());
+
+	const auto load = [](const Entry &entry) {
+		return entry.thread ? entry.thread->stats.sessions.load() : 0;
+	};
+	const auto i = ranges::min_element(list, ranges::less(), load);
+	if (!i->thread) {
+		const auto index = int(i - begin(list));
+		i->thread = std::make_unique<Thread>();
+		i->thread->setObjectName(
+			QString("MTP %1 Session (%2)").arg(name).arg(index));
+		i->context = std::make_unique<QObject>();
+		i->context->moveToThread(i->thread.get());
+		i->thread->start();
+	}
+	return i->thread.get();
+}
+
+void SessionThreads::sync() {
+	// The first pass destroys the killed SessionPrivate-s, their
+	// destructors post the deletion of their connections to the same
+	// threads, the second pass waits until those are destroyed as well.
+	for (auto pass = 0; pass != 2; ++pass) {
+		syncOnce();
+	}
+}
+
+void SessionThreads::syncOnce() {
+	const auto all = { &_regular, &_files };
+	for (const auto list : all) {
+		for (const auto &entry : *list) {
+			if (!entry.thread) {
+				continue;
+			}
+			// Deferred deletes posted earlier are processed before this.
+			auto semaphore = crl::semaphore();
+			InvokeQueued(entry.context.get(), [&] {
+				semaphore.release();
+			});
+			semaphore.acquire();
+		}
+	}
+}
+
+void SessionThreads::logStats() const {
+	if (!Logs::DebugEnabled()) {
+		return;
+	}
+	const auto all = { &_regular, &_files };
+	for (const auto list : all) {
+		for (const auto &entry : *list) {
+			if (!entry.thread) {
+				continue;
+			}
+			const auto &stats = entry.thread->stats;
+			DEBUG_LOG(("MTP Info: %1 - sessions %2, sent %3, received %4."
+				).arg(entry.thread->objectName()
+				).arg(stats.sessions.load()
+				).arg(stats.bytesSent.load()
+				).arg(stats.bytesReceived.load()));
+		}
+	}
+}
+
+SessionThreadStats *SessionThreads::Stats(not_null<QThread*> thread) {
+	const auto pooled = dynamic_cast<Thread*>(thread.get());
+	return pooled ? &pooled->stats : nullptr;
+}
+
+} // namespace MTP::details
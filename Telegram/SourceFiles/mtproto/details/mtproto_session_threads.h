@@ -0,0 +1,64 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <QtCore/QThread>
+
+#include <atomic>
+
+namespace MTP::details {
+
+struct SessionThreadStats {
+	std::atomic<int> sessions = 0;
+	std::atomic<int64> bytesSent = 0;
+	std::atomic<int64> bytesReceived = 0;
+};
+
+// Network threads shared by the MTP::Instance-s of all accounts.
+class SessionThreads final {
+public:
+	enum class Type {
+		Regular,
+		Files,
+	};
+
+	SessionThreads();
+	~SessionThreads();
+
+	[[nodiscard]] static std::shared_ptr<SessionThreads> Instance();
+
+	// Returns the thread of the given type with the fewest sessions.
+	[[nodiscard]] not_null<QThread*> choose(Type type);
+
+	// Blocks until everything queued to the started threads is processed.
+	void sync();
+
+	void logStats() const;
+
+	// nullptr if the thread doesn't belong to a SessionThreads pool.
+	[[nodiscard]] static SessionThreadStats *Stats(
+		not_null<QThread*> thread);
+
+private:
+	class Thread;
+	struct Entry {
+		std::unique_ptr<Thread> thread;
+		std::unique_ptr<QObject> context;
+	};
+
+	[[nodiscard]] not_null<QThread*> choose(
+		std::vector<Entry> &list,
+		const char *name);
+	void syncOnce();
+
+	std::vector<Entry> _regular;
+	std::vector<Entry> _files;
+
+};
+
+} // namespace MTP::details
@@ -28,6 +28,7 @@ const auto kServerHelloPart3 = qstr("\x14\x03\x03\x00\x01\x01\x17\x03\x03");
 constexpr auto kServerHelloDigestPosition = 11;
 const auto kServerHeader = qstr("\x17\x03\x03");
 constexpr auto kClientPartSize = 2878;
+constexpr auto kIncomingReserve = 64 * 1024;
 const auto kClientPrefix = qstr("\x14\x03\x03\x00\x01\x01");
 const auto kClientHeader = qstr("\x17\x03\x03");
 
@@ -652,6 +653,8 @@ void TlsSocket::plainConnected() {
 	} else {
 		_state = State::WaitingHello;
 		_incoming = hello.digest;
+		_incoming.reserve(kIncomingReserve);
+		_incomingStart = 0;
 		_socket.write(hello.data);
 	}
 }
@@ -659,6 +662,7 @@ void TlsSocket::plainConnected() {
 void TlsSocket::plainDisconnected() {
 	_state = State::NotConnected;
 	_incoming = QByteArray();
+	_incomingStart = 0;
 	_serverHelloLength = 0;
 	_incomingGoodDataOffset = 0;
 	_incomingGoodDataLimit = 0;
@@ -673,7 +677,7 @@ void TlsSocket::plainReadyRead() {
 }
 
 bool TlsSocket::requiredHelloPartReady() const {
-	return _incoming.size() >= kHelloDigestLength + _serverHelloLength;
+	return incomingSize() >= kHelloDigestLength + _serverHelloLength;
 }
 
 void TlsSocket::readHello() {
@@ -685,15 +689,13 @@ void TlsSocket::readHello() {
 		if (!_socket.bytesAvailable()) {
 			return;
 		}
-		_incoming.append(_socket.readAll());
+		appendIncoming();
 	}
 	checkHelloParts12(parts1Size);
 }
 
 void TlsSocket::checkHelloParts12(int parts1Size) {
-	const auto data = bytes::make_span(_incoming).subspan(
-		kHelloDigestLength,
-		parts1Size);
+	const auto data = incoming().subspan(kHelloDigestLength, parts1Size);
 	const auto part2Size = ReadPartLength(data, parts1Size - kLengthSize);
 	const auto parts123Size = parts1Size
 		+ part2Size
@@ -718,9 +720,7 @@ void TlsSocket::checkHelloParts12(int parts1Size) {
 }
 
 void TlsSocket::checkHelloParts34(int parts123Size) {
-	const auto data = bytes::make_span(_incoming).subspan(
-		kHelloDigestLength,
-		parts123Size);
+	const auto data = incoming().subspan(kHelloDigestLength, parts123Size);
 	const auto part4Size = ReadPartLength(data, parts123Size - kLengthSize);
 	const auto full = parts123Size + part4Size;
 	if (_serverHelloLength == parts123Size) {
@@ -742,7 +742,7 @@ void TlsSocket::checkHelloParts34(int parts123Size) {
 }
 
 void TlsSocket::checkHelloDigest() {
-	const auto fulldata = bytes::make_detached_span(_incoming).subspan(
+	const auto fulldata = incoming().subspan(
 		0,
 		kHelloDigestLength + _serverHelloLength);
 	const auto digest = fulldata.subspan(
@@ -757,7 +757,7 @@ void TlsSocket::checkHelloDigest() {
 		return;
 	}
 	shiftIncomingBy(fulldata.size());
-	if (!_incoming.isEmpty()) {
+	if (incomingSize() > 0) {
 		InvokeQueued(this, [=] {
 			if (!checkNextPacket()) {
 				handleError();
@@ -773,7 +773,7 @@ void TlsSocket::readData() {
 	if (!isConnected()) {
 		return;
 	}
-	_incoming.append(_socket.readAll());
+	appendIncoming();
 	if (!checkNextPacket()) {
 		handleError();
 	} else if (hasBytesAvailable()) {
@@ -783,7 +783,7 @@ void TlsSocket::readData() {
 
 bool TlsSocket::checkNextPacket() {
 	auto offset = 0;
-	const auto incoming = bytes::make_span(_incoming);
+	const auto incoming = this->incoming();
 	while (!_incomingGoodDataLimit) {
 		const auto fullHeader = kServerHeader.size() + kLengthSize;
 		if (incoming.size() <= offset + fullHeader) {
@@ -809,19 +809,50 @@ bool TlsSocket::checkNextPacket() {
 	return true;
 }
 
+void TlsSocket::appendIncoming() {
+	const auto available = int(_socket.bytesAvailable());
+	if (available <= 0) {
+		return;
+	}
+
+	// Records are parsed in place, so the unread tail is moved to the
+	// front only once per socket read, not after each consumed record.
+	if (_incomingStart > 0) {
+		const auto all = bytes::make_detached_span(_incoming);
+		const auto tail = all.subspan(_incomingStart);
+		bytes::move(all, tail);
+		_incoming.resize(tail.size());
+		_incomingStart = 0;
+	}
+
+	// Read straight into the spare capacity, without readAll() copies.
+	const auto was = int(_incoming.size());
+	_incoming.resize(was + available);
+	const auto read = _socket.read(_incoming.data() + was, available);
+	_incoming.resize(was + std::max(int(read), 0));
+}
+
 void TlsSocket::shiftIncomingBy(int amount) {
 	Expects(_incomingGoodDataOffset == 0);
 	Expects(_incomingGoodDataLimit == 0);
 
-	const auto incoming = bytes::make_detached_span(_incoming);
-	if (incoming.size() > amount) {
-		bytes::move(incoming, incoming.subspan(amount));
-		_incoming.chop(amount);
+	if (incomingSize() > amount) {
+		_incomingStart += amount;
 	} else {
-		_incoming.clear();
+		// Keeps the reserved capacity.
+		_incoming.resize(0);
+		_incomingStart = 0;
 	}
 }
 
+bytes::span TlsSocket::incoming() {
+	return bytes::make_detached_span(_incoming).subspan(_incomingStart);
+}
+
+int TlsSocket::incomingSize() const {
+	return int(_incoming.size()) - _incomingStart;
+}
+
 void TlsSocket::connectToHost(const QString &address, int port) {
 	Expects(_state == State::NotConnected);
 
@@ -843,7 +874,7 @@ bool TlsSocket::isConnected() {
 
 bool TlsSocket::hasBytesAvailable() {
 	return (_incomingGoodDataLimit > 0)
-		&& (_incomingGoodDataOffset < _incoming.size());
+		&& (_incomingGoodDataOffset < incomingSize());
 }
 
 int64 TlsSocket::read(bytes::span buffer) {
@@ -851,7 +882,7 @@ int64 TlsSocket::read(bytes::span buffer) {
 	while (_incomingGoodDataLimit) {
 		const auto available = std::min(
 			_incomingGoodDataLimit,
-			int(_incoming.size()) - _incomingGoodDataOffset);
+			incomingSize() - _incomingGoodDataOffset);
 		if (available <= 0) {
 			return written;
 		}
@@ -861,9 +892,7 @@ int64 TlsSocket::read(bytes::span buffer) {
 		}
 		bytes::copy(
 			buffer,
-			bytes::make_span(_incoming).subspan(
-				_incomingGoodDataOffset,
-				write));
+			incoming().subspan(_incomingGoodDataOffset, write));
 		written += write;
 		buffer = buffer.subspan(write);
 		_incomingGoodDataLimit -= write;
@@ -53,12 +53,16 @@ private:
 	void checkHelloDigest();
 	void readData();
 	[[nodiscard]] bool checkNextPacket();
+	void appendIncoming();
 	void shiftIncomingBy(int amount);
+	[[nodiscard]] bytes::span incoming();
+	[[nodiscard]] int incomingSize() const;
 
 	const bytes::vector _secret;
 	QTcpSocket _socket;
 	State _state = State::NotConnected;
 	QByteArray _incoming;
+	int _incomingStart = 0;
 	int _incomingGoodDataOffset = 0;
 	int _incomingGoodDataLimit = 0;
 	int16 _serverHelloLength = 0;
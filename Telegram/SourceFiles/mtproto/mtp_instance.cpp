@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "mtproto/details/mtproto_dcenter.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
+#include "mtproto/details/mtproto_session_threads.h"
 #include "mtproto/special_config_request.h"
 #include "mtproto/session.h"
 #include "mtproto/mtproto_config.h"
@@ -222,9 +223,7 @@ private:
 	const std::unique_ptr<Config> _config;
 	const std::shared_ptr<base::NetworkReachability> _networkReachability;
 
-	std::unique_ptr<QThread> _mainSessionThread;
-	std::unique_ptr<QThread> _otherSessionsThread;
-	std::vector<std::unique_ptr<QThread>> _fileSessionThreads;
+	const std::shared_ptr<details::SessionThreads> _threads;
 
 	QString _deviceModelDefault;
 	QString _systemVersion;
@@ -312,12 +311,10 @@ Instance::Private::Private(
 , _mode(mode)
 , _config(std::move(fields.config))
 , _networkReachability(base::NetworkReachability::Instance())
+, _threads(details::SessionThreads::Instance())
 , _proxySettings(Core::App().settings().proxy()) {
 	Expects(_config != nullptr);
 
-	const auto idealThreadPoolSize = QThread::idealThreadCount();
-	_fileSessionThreads.resize(2 * std::max(idealThreadPoolSize / 2, 1));
-
 	details::unpaused(
 	) | rpl::start_with_next([=] {
 		unpaused();
@@ -1655,52 +1652,10 @@ void Instance::Private::scheduleSessionDestroy(ShiftedDcId shiftedDcId) {
 
 not_null<QThread*> Instance::Private::getThreadForDc(
 		ShiftedDcId shiftedDcId) {
-	static const auto EnsureStarted = [](
-			std::unique_ptr<QThread> &thread,
-			auto name) {
-		if (!thread) {
-			thread = std::make_unique<QThread>();
-			thread->setObjectName(name());
-			thread->start();
-		}
-		return thread.get();
-	};
-	static const auto FindOne = [](
-			std::vector<std::unique_ptr<QThread>> &threads,
-			const char *prefix,
-			int index,
-			bool shift) {
-		Expects(!threads.empty());
-		Expects(!(threads.size() % 2));
-
-		const auto count = int(threads.size());
-		index %= count;
-		if (index >= count / 2) {
-			index = (count - 1) - (index - count / 2);
-		}
-		if (shift) {
-			index = (index + count / 2) % count;
-		}
-		return EnsureStarted(threads[index], [=] {
-			return QString("MTP %1 Session (%2)").arg(prefix).arg(index);
-		});
-	};
-	if (shiftedDcId == BareDcId(shiftedDcId)) {
-		return EnsureStarted(_mainSessionThread, [] {
-			return QString("MTP Main Session");
-		});
-	} else if (isDownloadDcId(shiftedDcId)) {
-		const auto index = GetDcIdShift(shiftedDcId) - kBaseDownloadDcShift;
-		const auto composed = index + BareDcId(shiftedDcId);
-		return FindOne(_fileSessionThreads, "Download", composed, false);
-	} else if (isUploadDcId(shiftedDcId)) {
-		const auto index = GetDcIdShift(shiftedDcId) - kBaseUploadDcShift;
-		const auto composed = index + BareDcId(shiftedDcId);
-		return FindOne(_fileSessionThreads, "Upload", composed, true);
-	}
-	return EnsureStarted(_otherSessionsThread, [] {
-		return QString("MTP Other Session");
-	});
+	using Type = details::SessionThreads::Type;
+	const auto files = isDownloadDcId(shiftedDcId)
+		|| isUploadDcId(shiftedDcId);
+	return _threads->choose(files ? Type::Files : Type::Regular);
 }
 
 void Instance::Private::scheduleKeyDestroy(ShiftedDcId shiftedDcId) {
@@ -1824,22 +1779,10 @@ void Instance::Private::prepareToDestroy() {
 	}
 	_mainSession = nullptr;
 
-	auto threads = std::vector<std::unique_ptr<QThread>>();
-	threads.push_back(base::take(_mainSessionThread));
-	threads.push_back(base::take(_otherSessionsThread));
-	for (auto &thread : base::take(_fileSessionThreads)) {
-		threads.push_back(std::move(thread));
-	}
-	for (const auto &thread : threads) {
-		if (thread) {
-			thread->quit();
-		}
-	}
-	for (const auto &thread : threads) {
-		if (thread) {
-			thread->wait();
-		}
-	}
+	// The threads are shared with other accounts, so instead of stopping
+	// them we wait until the killed connections are destroyed there.
+	_threads->sync();
+	_threads->logStats();
 }
 
 Instance::Instance(Mode mode, Fields &&fields)
@@ -18,7 +18,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace MTP {
 namespace {
 
-constexpr auto kVersion = 2;
+constexpr auto kVersion = 3;
+constexpr auto kMaxEndpointRtts = 64;
+
+// Smaller changes of a known rtt don't need the config to be written.
+constexpr auto kNoticeableRttChangeDivider = 4;
 
 using namespace details;
 
@@ -127,6 +131,8 @@ DcOptions::DcOptions(const DcOptions &other)
 , _publicKeys(other._publicKeys)
 , _cdnPublicKeys(other._cdnPublicKeys)
 , _immutable(other._immutable) {
+	QMutexLocker lock(&other._endpointRttsMutex);
+	_endpointRtts = other._endpointRtts;
 }
 
 DcOptions::~DcOptions() = default;
@@ -438,6 +444,18 @@ QByteArray DcOptions::serialize() const {
 		}
 	}
 
+	// Endpoint connect times.
+	auto rtts = [&] {
+		QMutexLocker lock(&_endpointRttsMutex);
+		return _endpointRtts;
+	}();
+	size += sizeof(qint32);
+	for (const auto &[key, rtt] : rtts) {
+		// dcId + protocol + port + rtt
+		size += sizeof(qint32) * 4;
+		size += sizeof(qint32) + std::get<2>(key).size();
+	}
+
 	auto result = QByteArray();
 	result.reserve(size);
 	{
@@ -471,6 +489,18 @@ QByteArray DcOptions::serialize() const {
 				<< Serialize::bytes(key.n)
 				<< Serialize::bytes(key.e);
 		}
+
+		// Endpoint connect times.
+		stream << qint32(rtts.size());
+		for (const auto &[key, rtt] : rtts) {
+			const auto &[dcId, protocol, ip, port] = key;
+			stream << qint32(dcId)
+				<< qint32(protocol)
+				<< qint32(port)
+				<< qint32(rtt)
+				<< qint32(ip.size());
+			stream.writeRawData(ip.data(), ip.size());
+		}
 	}
 	return result;
 }
@@ -566,6 +596,39 @@ bool DcOptions::constructFromSerialized(const QByteArray &serialized) {
 			}
 		}
 	}
+
+	// Read endpoint connect times.
+	if (!stream.atEnd() && version > 2) {
+		auto count = qint32(0);
+		stream >> count;
+		if (stream.status() != QDataStream::Ok
+			|| count < 0
+			|| count > kMaxEndpointRtts) {
+			LOG(("MTP Error: Bad data for endpoint times in DcOptions::constructFromSerialized()"));
+			return false;
+		}
+
+		auto rtts = base::flat_map<EndpointKey, crl::time>();
+		for (auto i = 0; i != count; ++i) {
+			qint32 dcId = 0, protocol = 0, port = 0, rtt = 0, ipSize = 0;
+			stream >> dcId >> protocol >> port >> rtt >> ipSize;
+
+			constexpr auto kMaxIpSize = 45;
+			if (ipSize <= 0 || ipSize > kMaxIpSize) {
+				LOG(("MTP Error: Bad data for endpoint times inside DcOptions::constructFromSerialized()"));
+				return false;
+			}
+			auto ip = std::string(ipSize, ' ');
+			stream.readRawData(ip.data(), ipSize);
+			if (stream.status() != QDataStream::Ok) {
+				LOG(("MTP Error: Bad data for endpoint times inside DcOptions::constructFromSerialized()"));
+				return false;
+			}
+			rtts.emplace(EndpointKey(dcId, protocol, ip, port), rtt);
+		}
+		QMutexLocker rttsLock(&_endpointRttsMutex);
+		_endpointRtts = std::move(rtts);
+	}
 	return true;
 }
 
@@ -595,6 +658,65 @@ std::vector<DcId> DcOptions::configEnumDcIds() const {
 	return result;
 }
 
+bool DcOptions::setEndpointRtt(
+		DcId dcId,
+		Variants::Protocol protocol,
+		const std::string &ip,
+		int port,
+		crl::time rtt) {
+	rtt = std::max(rtt, crl::time(1));
+
+	QMutexLocker lock(&_endpointRttsMutex);
+	const auto key = EndpointKey(dcId, protocol, ip, port);
+	const auto i = _endpointRtts.find(key);
+	if (i != end(_endpointRtts)) {
+		// Smooth the measurements, a single slow connect shouldn't
+		// demote an endpoint that was good for a long time.
+		const auto was = i->second;
+		i->second = (was * 3 + rtt) / 4;
+		const auto change = std::abs(i->second - was);
+		return (change * kNoticeableRttChangeDivider >= was);
+	} else if (_endpointRtts.size() >= kMaxEndpointRtts) {
+		const auto worst = ranges::max_element(
+			_endpointRtts,
+			ranges::less(),
+			[](const auto &pair) { return pair.second; });
+		if (worst->second <= rtt) {
+			return false;
+		}
+		_endpointRtts.erase(worst);
+	}
+	_endpointRtts.emplace(key, rtt);
+	return true;
+}
+
+bool DcOptions::forgetEndpointRtt(
+		DcId dcId,
+		Variants::Protocol protocol,
+		const std::string &ip,
+		int port) {
+	QMutexLocker lock(&_endpointRttsMutex);
+	return _endpointRtts.remove(EndpointKey(dcId, protocol, ip, port));
+}
+
+void DcOptions::notifyEndpointRttsChanged() {
+	_endpointRttsChanged.fire({});
+}
+
+rpl::producer<> DcOptions::endpointRttsChanged() const {
+	return _endpointRttsChanged.events();
+}
+
+crl::time DcOptions::endpointRtt(
+		DcId dcId,
+		Variants::Protocol protocol,
+		const std::string &ip,
+		int port) const {
+	QMutexLocker lock(&_endpointRttsMutex);
+	const auto i = _endpointRtts.find(EndpointKey(dcId, protocol, ip, port));
+	return (i != end(_endpointRtts)) ? i->second : 0;
+}
+
 DcType DcOptions::dcType(ShiftedDcId shiftedDcId) const {
 	if (isTemporaryDcId(shiftedDcId)) {
 		return DcType::Temporary;
@@ -10,10 +10,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/bytes.h"
 
 #include <QtCore/QReadWriteLock>
+#include <QtCore/QMutex>
 #include <string>
 #include <vector>
 #include <map>
 #include <set>
+#include <tuple>
 
 namespace MTP {
 namespace details {
@@ -105,6 +107,28 @@ public:
 		bool throughProxy) const;
 	[[nodiscard]] DcType dcType(ShiftedDcId shiftedDcId) const;
 
+	// Connect times measured by the sessions, zero if unknown.
+	// Setters return true if the saved table changed noticeably,
+	// then notifyEndpointRttsChanged() should be called on main.
+	[[nodiscard]] bool setEndpointRtt(
+		DcId dcId,
+		Variants::Protocol protocol,
+		const std::string &ip,
+		int port,
+		crl::time rtt);
+	[[nodiscard]] bool forgetEndpointRtt(
+		DcId dcId,
+		Variants::Protocol protocol,
+		const std::string &ip,
+		int port);
+	[[nodiscard]] crl::time endpointRtt(
+		DcId dcId,
+		Variants::Protocol protocol,
+		const std::string &ip,
+		int port) const;
+	void notifyEndpointRttsChanged();
+	[[nodiscard]] rpl::producer<> endpointRttsChanged() const;
+
 	void setCDNConfig(const MTPDcdnConfig &config);
 	[[nodiscard]] bool hasCDNKeysForDc(DcId dcId) const;
 	[[nodiscard]] details::RSAPublicKey getDcRSAKey(
@@ -116,6 +140,8 @@ public:
 	bool writeToFile(const QString &path) const;
 
 private:
+	using EndpointKey = std::tuple<DcId, int, std::string, int>;
+
 	bool applyOneGuarded(
 		DcId dcId,
 		Flags flags,
@@ -155,9 +181,12 @@ private:
 		DcId,
 		base::flat_map<uint64, details::RSAPublicKey>> _cdnPublicKeys;
 	mutable QReadWriteLock _useThroughLockers;
+	base::flat_map<EndpointKey, crl::time> _endpointRtts;
+	mutable QMutex _endpointRttsMutex;
 
 	rpl::event_stream<DcId> _changed;
 	rpl::event_stream<> _cdnConfigChanged;
+	rpl::event_stream<> _endpointRttsChanged;
 
 	// True when we have overriden options from a .tdesktop-endpoints file.
 	bool _immutable = false;
@@ -11,7 +11,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/details/mtproto_bound_key_creator.h"
 #include "mtproto/details/mtproto_dcenter.h"
 #include "mtproto/details/mtproto_dump_to_text.h"
+#include "mtproto/details/mtproto_request_stats.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
+#include "mtproto/details/mtproto_session_threads.h"
 #include "mtproto/session.h"
 #include "mtproto/mtproto_response.h"
 #include "mtproto/mtproto_dc_options.h"
@@ -20,6 +22,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/qthelp_url.h"
 #include "base/openssl_help.h"
 #include "base/unixtime.h"
+#include "core/startup_trace.h"
 #include "base/platform/base_platform_info.h"
 
 #include <ksandbox.h>
@@ -31,6 +34,7 @@ namespace {
 
 constexpr auto kIntSize = static_cast<int>(sizeof(mtpPrime));
 constexpr auto kWaitForBetterTimeout = crl::time(2000);
+constexpr auto kKnownBestPriority = 100;
 constexpr auto kMinConnectedTimeout = crl::time(1000);
 constexpr auto kMaxConnectedTimeout = crl::time(8000);
 constexpr auto kMinReceiveTimeout = crl::time(4000);
@@ -170,10 +174,14 @@ SessionPrivate::SessionPrivate(
 , _pingSender(thread, [=] { sendPingByTimer(); })
 , _checkSentRequestsTimer(thread, [=] { checkSentRequests(); })
 , _clearOldContainersTimer(thread, [=] { clearOldContainers(); })
-, _sessionData(std::move(data)) {
+, _sessionData(std::move(data))
+, _threadStats(SessionThreads::Stats(thread)) {
 	Expects(_shiftedDcId != 0);
 
 	moveToThread(thread);
+	if (_threadStats) {
+		++_threadStats->sessions;
+	}
 
 	InvokeQueued(this, [=] {
 		_clearOldContainersTimer.callEach(kSentContainerLives);
@@ -184,6 +192,9 @@ SessionPrivate::SessionPrivate(
 SessionPrivate::~SessionPrivate() {
 	releaseKeyCreationOnFail();
 	doDisconnect();
+	if (_threadStats) {
+		--_threadStats->sessions;
+	}
 
 	Expects(!_connection);
 	Expects(_testConnections.empty());
@@ -206,7 +217,11 @@ void SessionPrivate::appendTestConnection(
 			thread(),
 			protocolSecret,
 			_options->proxy),
-		priority
+		priority,
+		protocol,
+		ip.toStdString(),
+		port,
+		crl::now(),
 	});
 	const auto weak = _testConnections.back().data.get();
 	connect(weak, &AbstractConnection::error, [=](int errorCode) {
@@ -247,6 +262,75 @@ void SessionPrivate::appendTestConnection(
 	});
 }
 
+void SessionPrivate::preferKnownBestTestConnection() {
+	QWriteLocker lock(&_stateMutex);
+
+	// Use the endpoint that connected fastest before right away,
+	// instead of waiting for a better one by the static priorities.
+	const auto bareDc = BareDcId(_shiftedDcId);
+	const auto &options = _instance->dcOptions();
+	auto best = (TestConnection*)nullptr;
+	auto bestRtt = crl::time();
+	for (auto &test : _testConnections) {
+		const auto rtt = options.endpointRtt(
+			bareDc,
+			test.protocol,
+			test.ip,
+			test.port);
+		if (rtt > 0 && (!best || rtt < bestRtt)) {
+			best = &test;
+			bestRtt = rtt;
+		}
+	}
+	if (best) {
+		DEBUG_LOG(("MTP Info: preferring %1:%2 with known rtt %3."
+			).arg(QString::fromStdString(best->ip)
+			).arg(best->port
+			).arg(bestRtt));
+		best->priority = kKnownBestPriority;
+	}
+}
+
+void SessionPrivate::rememberTestConnectionRtt(const TestConnection &test) {
+	if (test.ip.empty()) {
+		return;
+	}
+	const auto changed = _instance->dcOptions().setEndpointRtt(
+		BareDcId(_shiftedDcId),
+		test.protocol,
+		test.ip,
+		test.port,
+		crl::now() - test.started);
+	if (changed) {
+		notifyEndpointRttsChanged();
+	}
+}
+
+void SessionPrivate::forgetTestConnectionRtt(
+		not_null<AbstractConnection*> connection) {
+	const auto i = ranges::find(
+		_testConnections,
+		connection.get(),
+		[](const TestConnection &test) { return test.data.get(); });
+	if (i == end(_testConnections) || i->ip.empty()) {
+		return;
+	}
+	const auto changed = _instance->dcOptions().forgetEndpointRtt(
+		BareDcId(_shiftedDcId),
+		i->protocol,
+		i->ip,
+		i->port);
+	if (changed) {
+		notifyEndpointRttsChanged();
+	}
+}
+
+void SessionPrivate::notifyEndpointRttsChanged() {
+	InvokeQueued(_instance, [instance = _instance] {
+		instance->dcOptions().notifyEndpointRttsChanged();
+	});
+}
+
 int16 SessionPrivate::getProtocolDcId() const {
 	const auto dcId = BareDcId(_shiftedDcId);
 	const auto simpleDcId = isTemporaryDcId(dcId)
@@ -1071,6 +1155,7 @@ void SessionPrivate::connectToServer(bool afterConfig) {
 				}
 			}
 		}
+		preferKnownBestTestConnection();
 	}
 	if (_testConnections.empty()) {
 		if (_instance->isKeysDestroyer()) {
@@ -1282,6 +1367,9 @@ void SessionPrivate::handleReceived() {
 		constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
 		auto intsCount = uint32(intsBuffer.size());
 		auto ints = intsBuffer.constData();
+		if (_threadStats) {
+			_threadStats->bytesReceived += intsCount * kIntSize;
+		}
 		if ((intsCount < kMinimalIntsCount) || (intsCount > kMaxMessageLength / kIntSize)) {
 			LOG(("TCP Error: bad message received, len %1").arg(intsCount * kIntSize));
 			return restart();
@@ -1840,6 +1928,7 @@ SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 		}
 
 		mtpTypeId typeId = from[0];
+		const auto receivedBytes = int((end - from) * sizeof(mtpPrime));
 		if (typeId == mtpc_gzip_packed) {
 			DEBUG_LOG(("RPC Info: gzip container"));
 			response = ungzip(++from, end);
@@ -1861,7 +1950,13 @@ SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 		} else {
 			_sessionData->notifyConnectionInited(*_options);
 		}
-		requestsAcked(ids, true);
+		auto stats = RequestStatsRecord{
+			.shiftedDcId = _shiftedDcId,
+			.receivedBytes = receivedBytes,
+			.unpackedBytes = int(response.size() * sizeof(mtpPrime)),
+		};
+		requestsAcked(ids, true, &stats);
+		recordResponseStats(stats, response);
 
 		const auto bindResult = handleBindResponse(requestMsgId, response);
 		if (bindResult != HandleResult::Ignored) {
@@ -2106,12 +2201,32 @@ void SessionPrivate::correctUnixtimeByFastRequest(
 	}
 }
 
+void SessionPrivate::recordResponseStats(
+		RequestStatsRecord record,
+		const mtpBuffer &response) {
+	if (!record.methodId) {
+		return;
+	}
+	if (!response.empty() && response[0] == mtpc_rpc_error) {
+		auto error = MTPRpcError();
+		auto from = response.constData();
+		if (error.read(from, from + response.size())) {
+			const auto &message = error.c_rpc_error().verror_message().v;
+			record.floodWait = message.startsWith("FLOOD_WAIT_");
+		}
+	}
+	RecordRequestStats(record);
+}
+
 void SessionPrivate::correctUnixtimeWithBadLocal(TimeId serverTime) {
 	SyncTimeRequestDuration = kFastRequestDuration;
 	base::unixtime::update(serverTime, true);
 }
 
-void SessionPrivate::requestsAcked(const QVector<MTPlong> &ids, bool byResponse) {
+void SessionPrivate::requestsAcked(
+		const QVector<MTPlong> &ids,
+		bool byResponse,
+		RequestStatsRecord *stats) {
 	DEBUG_LOG(("Message Info: requests acked, ids %1").arg(LogIdsVector(ids)));
 
 	QVector<MTPlong> toAckMore;
@@ -2142,6 +2257,16 @@ void SessionPrivate::requestsAcked(const QVector<MTPlong> &ids, bool byResponse)
 					DEBUG_LOG(("Message Info: ignoring ACK for msgId %1 because request %2 requires a response").arg(msgId).arg(requestId));
 					continue;
 				}
+				if (stats) {
+					const auto &request = i->second;
+					const auto body = SerializedRequest::kMessageBodyPosition;
+					if (request->size() > body) {
+						stats->methodId = mtpTypeId(request->at(body));
+					}
+					stats->latency = crl::now() - request->lastSentTime;
+					stats->sentBytes = int(
+						request.messageSize() * sizeof(mtpPrime));
+				}
 				haveSent.erase(i);
 
 				_ackedIds.emplace(msgId, requestId);
@@ -2320,6 +2445,7 @@ void SessionPrivate::onConnected(
 		connection.get(),
 		[](const TestConnection &test) { return test.data.get(); });
 	Assert(i != end(_testConnections));
+	rememberTestConnectionRtt(*i);
 	const auto my = i->priority;
 	const auto j = ranges::find_if(
 		_testConnections,
@@ -2587,6 +2713,7 @@ void SessionPrivate::authKeyChecked() {
 		handleReceived();
 	});
 
+	Core::StartupTrace::MarkFirst("MTP::connected");
 	if (_sessionSalt && setState(ConnectedState)) {
 		resendAll();
 	} // else receive salt in bad_server_salt first, then try to send all the requests
@@ -2606,6 +2733,7 @@ void SessionPrivate::onError(
 			instance->badConfigurationError();
 		});
 	}
+	forgetTestConnectionRtt(connection);
 	removeTestConnection(connection);
 
 	if (_testConnections.empty()) {
@@ -2691,6 +2819,9 @@ bool SessionPrivate::sendSecureRequest(
 
 	_connection->setSentEncryptedWithKeyId(_keyId);
 	_connection->sendData(std::move(packet));
+	if (_threadStats) {
+		_threadStats->bytesSent += (prefix + fullSize) * sizeof(mtpPrime);
+	}
 
 	if (needAnyResponse) {
 		onSentSome((prefix + fullSize) * sizeof(mtpPrime));
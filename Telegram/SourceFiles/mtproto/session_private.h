@@ -28,6 +28,8 @@ class AbstractConnection;
 class SessionData;
 class RSAPublicKey;
 struct SessionOptions;
+struct SessionThreadStats;
+struct RequestStatsRecord;
 
 class SessionPrivate final : public QObject {
 public:
@@ -56,6 +58,10 @@ private:
 	struct TestConnection {
 		ConnectionPointer data;
 		int priority = 0;
+		DcOptions::Variants::Protocol protocol = {};
+		std::string ip;
+		int port = 0;
+		crl::time started = 0;
 	};
 	struct SentContainer {
 		crl::time sent = 0;
@@ -144,6 +150,10 @@ private:
 		const QString &ip,
 		int port,
 		const bytes::vector &protocolSecret);
+	void preferKnownBestTestConnection();
+	void rememberTestConnectionRtt(const TestConnection &test);
+	void forgetTestConnectionRtt(not_null<AbstractConnection*> connection);
+	void notifyEndpointRttsChanged();
 
 	// if badTime received - search for ids in sessionData->haveSent and sessionData->wereAcked and sync time/salt, return true if found
 	bool requestsFixTimeSalt(const QVector<MTPlong> &ids, const OuterInfo &info);
@@ -153,9 +163,16 @@ private:
 		const QVector<MTPlong> &ids,
 		TimeId serverTime);
 	void correctUnixtimeWithBadLocal(TimeId serverTime);
+	void recordResponseStats(
+		RequestStatsRecord record,
+		const mtpBuffer &response);
 
 	// remove msgs with such ids from sessionData->haveSent, add to sessionData->wereAcked
-	void requestsAcked(const QVector<MTPlong> &ids, bool byResponse = false);
+	// if stats is passed, fills the method, latency and size of the request
+	void requestsAcked(
+		const QVector<MTPlong> &ids,
+		bool byResponse = false,
+		RequestStatsRecord *stats = nullptr);
 
 	void resend(mtpMsgId msgId, crl::time msCanWait = 0);
 	void resendAll();
@@ -217,6 +234,7 @@ private:
 	base::Timer _clearOldContainersTimer;
 
 	std::shared_ptr<SessionData> _sessionData;
+	SessionThreadStats * const _threadStats = nullptr;
 	std::unique_ptr<SessionOptions> _options;
 	AuthKeyPtr _encryptionKey;
 	uint64 _keyId = 0;
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "overview/overview_layout.h"
 
 #include "overview/overview_layout_delegate.h"
+#include "overview/overview_thumbnails.h"
 #include "core/ui_integration.h" // TextContext
 #include "data/data_document.h"
 #include "data/data_document_resolver.h"
@@ -68,33 +69,14 @@ constexpr auto kStoryRatio = 1.46;
 	return dimensions.width() * dimensions.height() <= kMaxInlineArea;
 }
 
-[[nodiscard]] QImage CropMediaFrame(QImage image, int width, int height) {
-	const auto ratio = style::DevicePixelRatio();
-	width *= ratio;
-	height *= ratio;
-	const auto finalize = [&](QImage result) {
-		result = result.scaled(
-			width,
-			height,
-			Qt::IgnoreAspectRatio,
-			Qt::SmoothTransformation);
-		result.setDevicePixelRatio(ratio);
-		return result;
-	};
-	if (image.width() * height == image.height() * width) {
-		if (image.width() != width) {
-			return finalize(std::move(image));
-		}
-		image.setDevicePixelRatio(ratio);
-		return image;
-	} else if (image.width() * height > image.height() * width) {
-		const auto use = (image.height() * width) / height;
-		const auto skip = (image.width() - use) / 2;
-		return finalize(image.copy(skip, 0, use, image.height()));
+void PaintThumbnail(QPainter &p, const QPixmap &pix, int width, int height) {
+	if (pix.isNull()) {
+		p.fillRect(0, 0, width, height, st::overviewPhotoBg);
+	} else if (pix.width() == width * style::DevicePixelRatio()) {
+		p.drawPixmap(0, 0, pix);
 	} else {
-		const auto use = (image.width() * height) / width;
-		const auto skip = (image.height() - use) / 2;
-		return finalize(image.copy(0, skip, image.width(), use));
+		// The thumbnail for the new size is still being prepared.
+		p.drawPixmap(QRect(0, 0, width, height), pix);
 	}
 }
 
@@ -364,35 +346,8 @@ int32 Photo::resizeGetHeight(int32 width) {
 
 void Photo::paint(Painter &p, const QRect &clip, TextSelection selection, const PaintContext *context) {
 	const auto selected = (selection == FullSelection);
-	const auto widthChanged = (_pix.width()
-		!= (_width * style::DevicePixelRatio()));
-	if (!_goodLoaded || widthChanged) {
-		ensureDataMediaCreated();
-		const auto good = !_spoiler
-			&& (_dataMedia->loaded()
-				|| _dataMedia->image(Data::PhotoSize::Thumbnail));
-		if ((good && !_goodLoaded) || widthChanged) {
-			_goodLoaded = good;
-			_pix = QPixmap();
-			if (_goodLoaded) {
-				setPixFrom(_dataMedia->image(Data::PhotoSize::Large)
-					? _dataMedia->image(Data::PhotoSize::Large)
-					: _dataMedia->image(Data::PhotoSize::Thumbnail));
-			} else if (const auto small = _spoiler
-				? nullptr
-				: _dataMedia->image(Data::PhotoSize::Small)) {
-				setPixFrom(small);
-			} else if (const auto blurred = _dataMedia->thumbnailInline()) {
-				setPixFrom(blurred);
-			}
-		}
-	}
-
-	if (_pix.isNull()) {
-		p.fillRect(0, 0, _width, _height, st::overviewPhotoBg);
-	} else {
-		p.drawPixmap(0, 0, _pix);
-	}
+	validatePix();
+	PaintThumbnail(p, _pix, _width, _height);
 
 	if (_spoiler) {
 		const auto paused = context->paused || On(PowerSaving::kChatSpoiler);
@@ -420,22 +375,63 @@ void Photo::paint(Painter &p, const QRect &clip, TextSelection selection, const
 	paintCheckbox(p, { checkLeft, checkTop }, selected, context);
 }
 
-void Photo::setPixFrom(not_null<Image*> image) {
-	Expects(_width > 0 && _height > 0);
-
-	auto img = image->original();
-	if (!_goodLoaded) {
-		img = Images::Blur(std::move(img));
+void Photo::validatePix() {
+	const auto widthChanged = (_pix.width()
+		!= (_width * style::DevicePixelRatio()));
+	if ((_goodLoaded && !widthChanged) || _width <= 0 || _height <= 0) {
+		return;
 	}
-	_pix = Ui::PixmapFromImage(
-		CropMediaFrame(std::move(img), _width, _height));
-
-	// In case we have inline thumbnail we can unload all images and we still
-	// won't get a blank image in the media viewer when the photo is opened.
-	if (!_data->inlineThumbnailBytes().isEmpty()) {
-		_dataMedia = nullptr;
-		delegate()->unregisterHeavyItem(this);
+	ensureDataMediaCreated();
+	const auto good = !_spoiler
+		&& (_dataMedia->loaded()
+			|| _dataMedia->image(Data::PhotoSize::Thumbnail));
+	if (!widthChanged && !good) {
+		return;
+	} else if (_preparingWidth == _width && (_preparingGood || !good)) {
+		return;
 	}
+	auto request = ThumbnailRequest{
+		.size = QSize(_width, _height),
+		.blurred = !good,
+	};
+	if (good) {
+		const auto large = _dataMedia->image(Data::PhotoSize::Large);
+		request.original = (large
+			? large
+			: _dataMedia->image(Data::PhotoSize::Thumbnail))->original();
+	} else if (const auto small = _spoiler
+		? nullptr
+		: _dataMedia->image(Data::PhotoSize::Small)) {
+		request.original = small->original();
+	} else if (!_data->inlineThumbnailBytes().isEmpty()) {
+		request.inlineBytes = _data->inlineThumbnailBytes();
+	} else {
+		return;
+	}
+	_preparingWidth = _width;
+	_preparingGood = good;
+	delegate()->prepareThumbnail(this, std::move(request), crl::guard(this, [=](
+			QImage image) {
+		_preparingWidth = 0;
+		if (image.isNull()) {
+			return;
+		}
+		_pix = Ui::PixmapFromImage(std::move(image));
+		_goodLoaded = good;
+		delegate()->repaintItem(this);
+
+		// In case we have inline thumbnail we can unload all images and we
+		// still won't get a blank image in the media viewer when the photo
+		// is opened.
+		if (!_data->inlineThumbnailBytes().isEmpty()) {
+			_dataMedia = nullptr;
+			delegate()->unregisterHeavyItem(this);
+		}
+	}));
+}
+
+void Photo::prefetchThumbnail() {
+	validatePix();
 }
 
 void Photo::ensureDataMediaCreated() const {
@@ -523,20 +519,6 @@ void Video::paint(Painter &p, const QRect &clip, TextSelection selection, const
 	ensureDataMediaCreated();
 
 	const auto selected = (selection == FullSelection);
-	const auto blurred = _videoCover
-		? _videoCoverMedia->thumbnailInline()
-		: _dataMedia->thumbnailInline();
-	const auto thumbnail = _spoiler
-		? nullptr
-		: _videoCover
-		? _videoCoverMedia->image(Data::PhotoSize::Small)
-		: _dataMedia->thumbnail();
-	const auto good = _spoiler
-		? nullptr
-		: _videoCover
-		? _videoCoverMedia->image(Data::PhotoSize::Large)
-		: _dataMedia->goodThumbnail();
-
 	bool loaded = dataLoaded(), displayLoading = _data->displayLoading();
 	if (displayLoading) {
 		ensureRadial();
@@ -548,24 +530,8 @@ void Video::paint(Painter &p, const QRect &clip, TextSelection selection, const
 	const auto radial = isRadialAnimation();
 	const auto radialOpacity = radial ? _radial->opacity() : 0.;
 
-	if ((blurred || thumbnail || good)
-		&& ((_pix.width() != _width * style::DevicePixelRatio())
-			|| (_pixBlurred && (thumbnail || good)))) {
-		auto img = good
-			? good->original()
-			: thumbnail
-			? thumbnail->original()
-			: Images::Blur(blurred->original());
-		_pix = Ui::PixmapFromImage(
-			CropMediaFrame(std::move(img), _width, _height));
-		_pixBlurred = !(thumbnail || good);
-	}
-
-	if (_pix.isNull()) {
-		p.fillRect(0, 0, _width, _height, st::overviewPhotoBg);
-	} else {
-		p.drawPixmap(0, 0, _pix);
-	}
+	validatePix();
+	PaintThumbnail(p, _pix, _width, _height);
 
 	if (_spoiler) {
 		const auto paused = context->paused || On(PowerSaving::kChatSpoiler);
@@ -642,6 +608,59 @@ void Video::paint(Painter &p, const QRect &clip, TextSelection selection, const
 	paintCheckbox(p, { checkLeft, checkTop }, selected, context);
 }
 
+void Video::validatePix() {
+	const auto thumbnail = _spoiler
+		? nullptr
+		: _videoCover
+		? _videoCoverMedia->image(Data::PhotoSize::Small)
+		: _dataMedia->thumbnail();
+	const auto good = _spoiler
+		? nullptr
+		: _videoCover
+		? _videoCoverMedia->image(Data::PhotoSize::Large)
+		: _dataMedia->goodThumbnail();
+	const auto sharp = (good || thumbnail);
+	const auto widthChanged = (_pix.width()
+		!= _width * style::DevicePixelRatio());
+	if ((!widthChanged && !(_pixBlurred && sharp))
+		|| _width <= 0
+		|| _height <= 0) {
+		return;
+	} else if (_preparingWidth == _width && (!_preparingBlurred || !sharp)) {
+		return;
+	}
+	auto request = ThumbnailRequest{ .size = QSize(_width, _height) };
+	if (sharp) {
+		request.original = (good ? good : thumbnail)->original();
+	} else if (_videoCover
+		? !_videoCover->inlineThumbnailBytes().isEmpty()
+		: (!_data->inlineThumbnailIsPath()
+			&& !_data->inlineThumbnailBytes().isEmpty())) {
+		request.inlineBytes = _videoCover
+			? _videoCover->inlineThumbnailBytes()
+			: _data->inlineThumbnailBytes();
+		request.blurred = true;
+	} else {
+		return;
+	}
+	_preparingWidth = _width;
+	_preparingBlurred = !sharp;
+	delegate()->prepareThumbnail(this, std::move(request), crl::guard(this, [=](
+			QImage image) {
+		_preparingWidth = 0;
+		if (!image.isNull()) {
+			_pix = Ui::PixmapFromImage(std::move(image));
+			_pixBlurred = !sharp;
+			delegate()->repaintItem(this);
+		}
+	}));
+}
+
+void Video::prefetchThumbnail() {
+	ensureDataMediaCreated();
+	validatePix();
+}
+
 void Video::ensureDataMediaCreated() const {
 	if (_dataMedia && (!_videoCover || _videoCoverMedia)) {
 		return;
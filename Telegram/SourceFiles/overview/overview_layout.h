@@ -76,6 +76,10 @@ public:
 	virtual void clearHeavyPart() {
 	}
 
+	// Called for items near the visible area, before they are painted.
+	virtual void prefetchThumbnail() {
+	}
+
 protected:
 	[[nodiscard]] not_null<HistoryItem*> parent() const {
 		return _parent;
@@ -209,10 +213,11 @@ public:
 
 	void itemDataChanged() override;
 	void clearHeavyPart() override;
+	void prefetchThumbnail() override;
 
 private:
 	void ensureDataMediaCreated() const;
-	void setPixFrom(not_null<Image*> image);
+	void validatePix();
 	void clearSpoiler();
 
 	const not_null<PhotoData*> _data;
@@ -221,6 +226,8 @@ private:
 	std::unique_ptr<Ui::SpoilerAnimation> _spoiler;
 
 	QPixmap _pix;
+	int _preparingWidth = 0;
+	bool _preparingGood = false;
 	bool _goodLoaded = false;
 	bool _pinned = false;
 	bool _story = false;
@@ -304,6 +311,7 @@ public:
 	void itemDataChanged() override;
 	void clearHeavyPart() override;
 	void clearSpoiler() override;
+	void prefetchThumbnail() override;
 
 protected:
 	float64 dataProgress() const override;
@@ -313,6 +321,7 @@ protected:
 
 private:
 	void ensureDataMediaCreated() const;
+	void validatePix();
 	void updateStatusText();
 
 	const not_null<DocumentData*> _data;
@@ -325,6 +334,8 @@ private:
 	std::unique_ptr<Ui::SpoilerAnimation> _spoiler;
 
 	QPixmap _pix;
+	int _preparingWidth = 0;
+	bool _preparingBlurred = false;
 	bool _pixBlurred = true;
 	bool _pinned = false;
 	bool _story = false;
@@ -11,6 +11,7 @@ namespace Overview {
 namespace Layout {
 
 class ItemBase;
+struct ThumbnailRequest;
 
 class Delegate {
 public:
@@ -19,6 +20,13 @@ public:
 	virtual void repaintItem(not_null<const ItemBase*> item) = 0;
 	virtual bool itemVisible(not_null<const ItemBase*> item) = 0;
 
+	// The 'done' is called on the main thread, with a null QImage
+	// if the request was cancelled or the image could not be prepared.
+	virtual void prepareThumbnail(
+		not_null<const ItemBase*> item,
+		ThumbnailRequest &&request,
+		Fn<void(QImage)> done) = 0;
+
 	virtual void openPhoto(not_null<PhotoData*> photo, FullMsgId id) = 0;
 	virtual void openDocument(
 		not_null<DocumentData*> document,
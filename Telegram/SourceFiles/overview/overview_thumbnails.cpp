@@ -0,0 +1,178 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "overview/overview_thumbnails.h"
+
+#include "ui/image/image_prepare.h"
+
+namespace Overview {
+namespace Layout {
+namespace {
+
+constexpr auto kMaxThreads = 4;
+
+[[nodiscard]] QImage CropMediaFrame(
+		QImage image,
+		int width,
+		int height,
+		int ratio) {
+	width *= ratio;
+	height *= ratio;
+	const auto finalize = [&](QImage result) {
+		result = result.scaled(
+			width,
+			height,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		result.setDevicePixelRatio(ratio);
+		return result;
+	};
+	if (image.width() * height == image.height() * width) {
+		if (image.width() != width) {
+			return finalize(std::move(image));
+		}
+		image.setDevicePixelRatio(ratio);
+		return image;
+	} else if (image.width() * height > image.height() * width) {
+		const auto use = (image.height() * width) / height;
+		const auto skip = (image.width() - use) / 2;
+		return finalize(image.copy(skip, 0, use, image.height()));
+	} else {
+		const auto use = (image.width() * height) / width;
+		const auto skip = (image.height() - use) / 2;
+		return finalize(image.copy(0, skip, image.width(), use));
+	}
+}
+
+[[nodiscard]] QImage Prepare(ThumbnailRequest &&request, int ratio) {
+	auto image = request.original.isNull()
+		? Images::FromInlineBytes(request.inlineBytes)
+		: std::move(request.original);
+	if (image.isNull() || request.size.isEmpty()) {
+		return QImage();
+	} else if (request.blurred) {
+		image = Images::Blur(std::move(image));
+	}
+	return CropMediaFrame(
+		std::move(image),
+		request.size.width(),
+		request.size.height(),
+		ratio);
+}
+
+} // namespace
+
+ThumbnailPreparer::ThumbnailPreparer()
+: _threads(std::clamp(QThread::idealThreadCount() / 2, 1, kMaxThreads)) {
+}
+
+ThumbnailPreparer::~ThumbnailPreparer() = default;
+
+void ThumbnailPreparer::prepare(
+		not_null<const ItemBase*> item,
+		ThumbnailRequest &&request,
+		int priority,
+		Fn<void(QImage)> done) {
+	_running.remove(item);
+	_pending[item] = Pending{
+		.request = std::move(request),
+		.done = std::move(done),
+		.priority = priority,
+		.id = ++_lastId,
+	};
+	startNext();
+}
+
+void ThumbnailPreparer::refreshPriorities(
+		Fn<std::optional<int>(not_null<const ItemBase*>)> priority) {
+	auto cancelled = std::vector<Fn<void(QImage)>>();
+	for (auto i = begin(_pending); i != end(_pending);) {
+		if (const auto value = priority(i->first)) {
+			i->second.priority = *value;
+			++i;
+		} else {
+			cancelled.push_back(std::move(i->second.done));
+			i = _pending.erase(i);
+		}
+	}
+	for (auto i = begin(_running); i != end(_running);) {
+		if (priority(i->first)) {
+			++i;
+		} else {
+			cancelled.push_back(std::move(i->second.done));
+			i = _running.erase(i);
+		}
+	}
+	for (const auto &done : cancelled) {
+		done(QImage());
+	}
+}
+
+void ThumbnailPreparer::cancel(not_null<const ItemBase*> item) {
+	auto cancelled = std::vector<Fn<void(QImage)>>();
+	if (const auto i = _pending.find(item); i != end(_pending)) {
+		cancelled.push_back(std::move(i->second.done));
+		_pending.erase(i);
+	}
+	if (const auto i = _running.find(item); i != end(_running)) {
+		cancelled.push_back(std::move(i->second.done));
+		_running.erase(i);
+	}
+	for (const auto &done : cancelled) {
+		done(QImage());
+	}
+}
+
+void ThumbnailPreparer::cancelAll() {
+	refreshPriorities([](not_null<const ItemBase*>) {
+		return std::optional<int>();
+	});
+}
+
+void ThumbnailPreparer::startNext() {
+	const auto ratio = style::DevicePixelRatio();
+	while (_runningCount < _threads && !_pending.empty()) {
+		const auto i = ranges::min_element(
+			_pending,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.priority; });
+		const auto item = i->first;
+		auto pending = std::move(i->second);
+		_pending.erase(i);
+
+		const auto id = pending.id;
+		_running[item] = Running{ std::move(pending.done), id };
+		++_runningCount;
+		crl::async([
+			=,
+			weak = base::make_weak(this),
+			request = std::move(pending.request)
+		]() mutable {
+			auto result = Prepare(std::move(request), ratio);
+			crl::on_main(weak, [=, result = std::move(result)]() mutable {
+				finished(item, id, std::move(result));
+			});
+		});
+	}
+}
+
+void ThumbnailPreparer::finished(
+		not_null<const ItemBase*> item,
+		uint64 id,
+		QImage result) {
+	--_runningCount;
+	const auto i = _running.find(item);
+	if (i != end(_running) && i->second.id == id) {
+		const auto done = std::move(i->second.done);
+		_running.erase(i);
+		done(std::move(result));
+	}
+	startNext();
+}
+
+} // namespace Layout
+} // namespace Overview
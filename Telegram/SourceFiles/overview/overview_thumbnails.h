@@ -0,0 +1,72 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+namespace Overview {
+namespace Layout {
+
+class ItemBase;
+
+struct ThumbnailRequest {
+	QImage original;
+	QByteArray inlineBytes; // Decoded on a worker if 'original' is null.
+	QSize size;
+	bool blurred = false;
+};
+
+// Crops, scales and blurs grid thumbnails on worker threads.
+// Requests with smaller priority values are started first.
+class ThumbnailPreparer final : public base::has_weak_ptr {
+public:
+	ThumbnailPreparer();
+	~ThumbnailPreparer();
+
+	// Replaces the previous request for the same item.
+	void prepare(
+		not_null<const ItemBase*> item,
+		ThumbnailRequest &&request,
+		int priority,
+		Fn<void(QImage)> done);
+
+	// Requests with std::nullopt priority are cancelled,
+	// cancelled requests receive a null QImage.
+	void refreshPriorities(
+		Fn<std::optional<int>(not_null<const ItemBase*>)> priority);
+	void cancel(not_null<const ItemBase*> item);
+	void cancelAll();
+
+private:
+	struct Pending {
+		ThumbnailRequest request;
+		Fn<void(QImage)> done;
+		int priority = 0;
+		uint64 id = 0;
+	};
+	struct Running {
+		Fn<void(QImage)> done;
+		uint64 id = 0;
+	};
+
+	void startNext();
+	void finished(
+		not_null<const ItemBase*> item,
+		uint64 id,
+		QImage result);
+
+	const int _threads = 1;
+	base::flat_map<not_null<const ItemBase*>, Pending> _pending;
+	base::flat_map<not_null<const ItemBase*>, Running> _running;
+	int _runningCount = 0;
+	uint64 _lastId = 0;
+
+};
+
+} // namespace Layout
+} // namespace Overview
@@ -22,12 +22,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "mtproto/mtp_instance.h"
 #include "mtproto/mtproto_dc_options.h"
+#include "mtproto/details/mtproto_request_stats.h"
 #include "core/file_utilities.h"
 #include "core/update_checker.h"
 #include "window/themes/window_theme.h"
 #include "window/themes/window_theme_editor.h"
 #include "window/window_session_controller.h"
 #include "media/audio/media_audio_track.h"
+#include "media/streaming/media_streaming_slices_budget.h"
 #include "settings/settings_folders.h"
 #include "storage/storage_account.h"
 #include "api/api_updates.h"
@@ -87,6 +89,24 @@ auto GenerateCodes() {
 	codes.emplace(u"viewlogs"_q, [](SessionController *window) {
 		File::ShowInFolder(cWorkingDir() + "log.txt");
 	});
+	codes.emplace(u"mtpstats"_q, [](SessionController *window) {
+		const auto path = cWorkingDir() + "mtp_stats.txt";
+		if (MTP::details::DumpRequestStats(path)) {
+			File::ShowInFolder(path);
+		}
+	});
+	codes.emplace(u"streamingstats"_q, [](SessionController *window) {
+		const auto stats = Media::Streaming::CollectSlicesMemoryStats();
+		const auto mb = [](int64 bytes) {
+			return QString::number(bytes / 1024. / 1024., 'f', 1);
+		};
+		Ui::Toast::Show(u"Streaming slices: %1 MB of %2 MB, "
+			"%3 readers, %4 limited."_q
+			.arg(mb(stats.bytes))
+			.arg(mb(stats.limit))
+			.arg(stats.readers)
+			.arg(stats.limited));
+	});
 	if (!Core::UpdaterDisabled()) {
 		codes.emplace(u"testupdate"_q, [](SessionController *window) {
 			Core::UpdateChecker().test();
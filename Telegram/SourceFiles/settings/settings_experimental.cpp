@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/options.h"
 #include "core/application.h"
 #include "core/launcher.h"
+#include "calls/group/calls_group_viewport.h"
 #include "chat_helpers/tabbed_panel.h"
 #include "dialogs/dialogs_widget.h"
 #include "history/history_item_components.h"
@@ -159,6 +160,7 @@ void SetupExperimental(
 	addToggle(Data::kOptionExternalVideoPlayer);
 	addToggle(Window::kOptionNewWindowsSizeAsFirst);
 	addToggle(MTP::details::kOptionPreferIPv6);
+	addToggle(Calls::Group::kOptionGroupCallFrameTimes);
 	if (base::options::lookup<bool>(kOptionFastButtonsMode).value()) {
 		addToggle(kOptionFastButtonsMode);
 	}
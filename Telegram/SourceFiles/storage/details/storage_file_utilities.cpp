@@ -22,6 +22,9 @@ namespace {
 
 constexpr char TdfMagic[] = { 'T', 'D', 'F', '$' };
 constexpr auto TdfMagicLen = int(sizeof(TdfMagic));
+constexpr char TdjMagic[] = { 'T', 'D', 'J', '$' };
+constexpr auto TdjMagicLen = int(sizeof(TdjMagic));
+constexpr auto kJournalPostfix = 'j';
 
 constexpr auto kStrongIterationsCount = 100'000;
 
@@ -32,6 +35,14 @@ struct WriteEntry {
 	QByteArray md5;
 };
 
+struct JournalEntry {
+	QString basePath;
+	QString base;
+	QByteArray data;
+	Fn<void()> failed;
+	bool start = false;
+};
+
 class WriteManager final {
 public:
 	explicit WriteManager(crl::weak_on_thread<WriteManager> weak);
@@ -39,6 +50,7 @@ public:
 	void write(WriteEntry &&entry);
 	void writeSync(WriteEntry &&entry);
 	void writeSyncAll();
+	void writeJournal(JournalEntry &&entry);
 
 private:
 	void scheduleWrite();
@@ -52,7 +64,8 @@ private:
 	[[nodiscard]] QString path(const WriteEntry &entry, char postfix) const;
 	[[nodiscard]] bool writeHeader(
 		const QString &basePath,
-		QFileDevice &file);
+		QFileDevice &file,
+		const char *magic = TdfMagic);
 
 	crl::weak_on_thread<WriteManager> _weak;
 	std::deque<WriteEntry> _scheduled;
@@ -63,6 +76,7 @@ class AsyncWriteManager final {
 public:
 	void write(WriteEntry &&entry);
 	void writeSync(WriteEntry &&entry);
+	void writeJournal(JournalEntry &&entry);
 	void sync();
 	void stop();
 
@@ -152,7 +166,45 @@ bool WriteManager::writeOneScheduledNow() {
 	return true;
 }
 
-bool WriteManager::writeHeader(const QString &basePath, QFileDevice &file) {
+void WriteManager::writeJournal(JournalEntry &&entry) {
+	QFile file(entry.base + kJournalPostfix);
+	if (entry.start) {
+		// The snapshot the journal is bound to must be on disk
+		// before the records appended to the previous one are dropped.
+		const auto i = ranges::find(_scheduled, entry.base, &WriteEntry::base);
+		if (i != end(_scheduled)) {
+			auto snapshot = std::move(*i);
+			_scheduled.erase(i);
+			writeNow(std::move(snapshot));
+		}
+		if (!writeHeader(entry.basePath, file, TdjMagic)) {
+			LOG(("Storage Error: Could not open '%1' for writing."
+				).arg(file.fileName()));
+			entry.failed();
+			return;
+		}
+	} else if (!file.exists()) {
+		LOG(("Storage Error: Journal '%1' is missing."
+			).arg(file.fileName()));
+		entry.failed();
+		return;
+	} else if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		LOG(("Storage Error: Could not open '%1' for appending."
+			).arg(file.fileName()));
+		entry.failed();
+		return;
+	}
+	if (file.write(entry.data) != entry.data.size()) {
+		LOG(("Storage Error: Could not write to '%1'."
+			).arg(file.fileName()));
+		entry.failed();
+	}
+}
+
+bool WriteManager::writeHeader(
+		const QString &basePath,
+		QFileDevice &file,
+		const char *magic) {
 	if (!file.open(QIODevice::WriteOnly)) {
 		const auto dir = QDir(basePath);
 		if (dir.exists()) {
@@ -163,7 +215,7 @@ bool WriteManager::writeHeader(const QString &basePath, QFileDevice &file) {
 			return false;
 		}
 	}
-	file.write(TdfMagic, TdfMagicLen);
+	file.write(magic, TdfMagicLen);
 	const auto version = qint32(AppVersion);
 	file.write((const char*)&version, sizeof(version));
 	return true;
@@ -218,6 +270,17 @@ void AsyncWriteManager::writeSync(WriteEntry &&entry) {
 	});
 }
 
+void AsyncWriteManager::writeJournal(JournalEntry &&entry) {
+	Expects(!_finished);
+
+	if (!_manager) {
+		_manager.emplace();
+	}
+	_manager->with([entry = std::move(entry)](WriteManager &manager) mutable {
+		manager.writeJournal(std::move(entry));
+	});
+}
+
 void AsyncWriteManager::sync() {
 	if (_manager) {
 		_manager->with_sync([](WriteManager &manager) {
@@ -288,6 +351,8 @@ void ClearKey(const FileKey &key, const QString &basePath) {
 	QFile::remove(name);
 	name[name.size() - 1] = 's';
 	QFile::remove(name);
+	name[name.size() - 1] = kJournalPostfix;
+	QFile::remove(name);
 }
 
 bool CheckStreamStatus(QDataStream &stream) {
@@ -665,6 +730,137 @@ bool ReadEncryptedFile(
 	return ReadEncryptedFile(result, ToFilePart(fkey), basePath, key);
 }
 
+std::optional<DecryptedFile> ReadDecryptedFile(
+		const FileKey &fkey,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key) {
+	return ReadDecryptedFile(ToFilePart(fkey), basePath, key);
+}
+
+std::optional<DecryptedFile> ReadDecryptedFile(
+		const QString &name,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key) {
+	FileReadDescriptor file;
+	if (!ReadEncryptedFile(file, name, basePath, key)) {
+		return std::nullopt;
+	}
+	return DecryptedFile{
+		.version = file.version,
+		.data = file.data,
+		.position = file.buffer.pos(),
+	};
+}
+
+void OpenDecryptedFile(FileReadDescriptor &result, DecryptedFile &&file) {
+	Expects(!result.version);
+
+	result.version = file.version;
+	result.data = std::move(file.data);
+	result.buffer.setBuffer(&result.data);
+	result.buffer.open(QIODevice::ReadOnly);
+	result.buffer.seek(file.position);
+	result.stream.setDevice(&result.buffer);
+	result.stream.setVersion(QDataStream::Qt_5_1);
+}
+
+void StartJournal(
+		const FileKey &fkey,
+		const QString &basePath,
+		uint64 salt,
+		Fn<void()> failed) {
+	auto data = QByteArray();
+	{
+		QDataStream stream(&data, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << quint64(salt);
+	}
+	Manager.writeJournal({
+		.basePath = basePath,
+		.base = basePath + ToFilePart(fkey),
+		.data = std::move(data),
+		.failed = std::move(failed),
+		.start = true,
+	});
+}
+
+int AppendJournal(
+		const FileKey &fkey,
+		const QString &basePath,
+		EncryptedDescriptor &record,
+		const MTP::AuthKeyPtr &key,
+		Fn<void()> failed) {
+	auto data = QByteArray();
+	{
+		QDataStream stream(&data, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << PrepareEncrypted(record, key);
+	}
+	const auto result = int(data.size());
+	Manager.writeJournal({
+		.basePath = basePath,
+		.base = basePath + ToFilePart(fkey),
+		.data = std::move(data),
+		.failed = std::move(failed),
+	});
+	return result;
+}
+
+int64 ReadJournal(
+		const FileKey &fkey,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key,
+		uint64 salt,
+		Fn<void(EncryptedDescriptor &record)> apply) {
+	const auto name = ToFilePart(fkey) + kJournalPostfix;
+	QFile f(basePath + name);
+	if (!f.open(QIODevice::ReadOnly)) {
+		return -1;
+	}
+	const auto bytes = f.readAll();
+	const auto headerSize = TdjMagicLen + int(sizeof(qint32));
+	if (bytes.size() < headerSize
+		|| memcmp(bytes.constData(), TdjMagic, TdjMagicLen)) {
+		DEBUG_LOG(("App Info: bad journal header in '%1'").arg(name));
+		return -1;
+	}
+	auto version = qint32();
+	memcpy(&version, bytes.constData() + TdjMagicLen, sizeof(version));
+	if (version > AppVersion) {
+		DEBUG_LOG(("App Info: version too big %1 for '%2', my version %3"
+			).arg(version
+			).arg(name
+			).arg(AppVersion));
+		return -1;
+	}
+
+	QDataStream stream(bytes);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream.skipRawData(headerSize);
+
+	auto journalSalt = quint64();
+	stream >> journalSalt;
+	if (!CheckStreamStatus(stream) || journalSalt != salt) {
+		DEBUG_LOG(("App Info: stale journal '%1'").arg(name));
+		return -1;
+	}
+	while (!stream.atEnd()) {
+		auto encrypted = QByteArray();
+		stream >> encrypted;
+		auto record = EncryptedDescriptor();
+		if (!CheckStreamStatus(stream)
+			|| !DecryptLocal(record, encrypted, key)) {
+			// The last record could be written only partially.
+			LOG(("App Info: journal '%1' is broken after %2 bytes."
+				).arg(name
+				).arg(stream.device()->pos()));
+			return -1;
+		}
+		apply(record);
+	}
+	return bytes.size();
+}
+
 void Sync() {
 	Manager.sync();
 }
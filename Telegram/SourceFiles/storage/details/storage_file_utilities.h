@@ -106,6 +106,53 @@ bool ReadEncryptedFile(
 	const QString &basePath,
 	const MTP::AuthKeyPtr &key);
 
+// Decrypted file contents, that can be prepared on any thread
+// and then opened as a FileReadDescriptor on the main one.
+struct DecryptedFile {
+	int32 version = 0;
+	QByteArray data;
+	qint64 position = 0;
+};
+
+[[nodiscard]] std::optional<DecryptedFile> ReadDecryptedFile(
+	const QString &name,
+	const QString &basePath,
+	const MTP::AuthKeyPtr &key);
+[[nodiscard]] std::optional<DecryptedFile> ReadDecryptedFile(
+	const FileKey &fkey,
+	const QString &basePath,
+	const MTP::AuthKeyPtr &key);
+void OpenDecryptedFile(FileReadDescriptor &result, DecryptedFile &&file);
+
+// Encrypted append-only journal, stored next to the file of the same key.
+// Each record is encrypted separately, so appending costs only the size
+// of the record. The salt binds the journal to its snapshot file, so the
+// journal is started again each time the snapshot is rewritten.
+//
+// Writes are queued, so 'failed' is called later from the writer thread
+// if the journal could not be written. Records appended after that are
+// lost and the snapshot should be rewritten.
+void StartJournal(
+	const FileKey &fkey,
+	const QString &basePath,
+	uint64 salt,
+	Fn<void()> failed);
+int AppendJournal(
+	const FileKey &fkey,
+	const QString &basePath,
+	EncryptedDescriptor &record,
+	const MTP::AuthKeyPtr &key,
+	Fn<void()> failed);
+
+// Returns the journal size or -1 if it is missing, stale or broken,
+// records are applied in order until the first broken one.
+[[nodiscard]] int64 ReadJournal(
+	const FileKey &fkey,
+	const QString &basePath,
+	const MTP::AuthKeyPtr &key,
+	uint64 salt,
+	Fn<void(EncryptedDescriptor &record)> apply);
+
 void Sync();
 void Finish();
 
@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/file_location.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_write_back.h"
 #include "storage/file_download_mtproto.h"
 #include "storage/file_download_web.h"
 #include "platform/platform_file_utilities.h"
@@ -280,6 +281,7 @@ void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 				std::move(image));
 		});
 	};
+	_session->data().cacheWriteBack().flush(key);
 	_session->data().cache().get(key, [=, callback = std::move(done)](
 			QByteArray &&value) mutable {
 		if (readImage && !value.startsWith("partial:")) {
@@ -382,7 +384,16 @@ bool FileLoader::writeResultPart(int64 offset, bytes::const_span buffer) {
 		}
 		return true;
 	}
-	_data.reserve(offset + buffer.size());
+	const auto required = offset + int64(buffer.size());
+	if (required > _data.capacity()) {
+		// Reserving exactly for each part reallocates and copies
+		// everything loaded so far, so grow to the full size at once.
+		_data.reserve(std::max({
+			required,
+			_fullSize,
+			int64(_data.capacity()) * 2,
+		}));
+	}
 	if (offset > _data.size()) {
 		_skippedBytes += offset - _data.size();
 		_data.resize(offset);
@@ -458,8 +469,8 @@ bool FileLoader::finalizeResult() {
 		if ((_toCache == LoadToCacheAsWell)
 			&& (_data.size() <= Storage::kMaxFileInMemory)
 			&& (key.low || key.high)) {
-			_session->data().cache().put(
-				cacheKey(),
+			_session->data().cacheWriteBack().put(
+				key,
 				Storage::Cache::Database::TaggedValue(
 					base::duplicate((!_fullSize || _data.size() == _fullSize)
 						? _data
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_send_progress.h"
 #include "storage/localimageloader.h"
 #include "storage/file_download.h"
+#include "storage/storage_cache_write_back.h"
 #include "data/data_document.h"
 #include "data/data_document_media.h"
 #include "data/data_photo.h"
@@ -320,7 +321,7 @@ void Uploader::upload(
 			}
 		}
 		if (!file->goodThumbnailBytes.isEmpty()) {
-			document->owner().cache().putIfEmpty(
+			document->owner().cacheWriteBack().putIfEmpty(
 				document->goodThumbnailCacheKey(),
 				Storage::Cache::Database::TaggedValue(
 					std::move(file->goodThumbnailBytes),
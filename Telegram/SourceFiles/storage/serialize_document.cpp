@@ -74,11 +74,10 @@ void Document::writeToStream(QDataStream &stream, DocumentData *document) {
 		<< document->inlineThumbnailBytes();
 }
 
-DocumentData *Document::readFromStreamHelper(
-		not_null<Main::Session*> session,
+auto Document::parseFromStreamHelper(
 		int streamAppVersion,
 		QDataStream &stream,
-		const StickerSetInfo *info) {
+		const StickerSetInfo *info) -> std::optional<Parsed> {
 	quint64 id, access;
 	QString name, mime;
 	qint32 date, dc, size, width, height, type, versionTag, version = 0;
@@ -153,7 +152,7 @@ DocumentData *Document::readFromStreamHelper(
 				if (version < 5) {
 					// We didn't store useTextColor yet, can't use.
 					stream.setStatus(QDataStream::ReadCorruptData);
-					return nullptr;
+					return std::nullopt;
 				}
 				using Flag = MTPDdocumentAttributeCustomEmoji::Flag;
 				attributes.push_back(MTP_documentAttributeCustomEmoji(
@@ -223,7 +222,7 @@ DocumentData *Document::readFromStreamHelper(
 		|| !thumb
 		|| !videoThumb) {
 		stream.setStatus(QDataStream::ReadCorruptData);
-		return nullptr;
+		return std::nullopt;
 	}
 	const auto storage = std::get_if<StorageFileLocation>(
 		&thumb->file().data);
@@ -232,30 +231,68 @@ DocumentData *Document::readFromStreamHelper(
 		stream.setStatus(QDataStream::ReadCorruptData);
 		// We can't convert legacy thumbnail location to modern, because
 		// size letter ('s' or 'm') is lost, it was not saved in legacy.
-		return nullptr;
+		return std::nullopt;
 	}
-	return session->data().document(
-		id,
-		access,
-		fileReference,
-		date,
-		attributes,
-		mime,
-		InlineImageLocation{
+	return Parsed{
+		.id = id,
+		.access = access,
+		.fileReference = fileReference,
+		.date = date,
+		.attributes = std::move(attributes),
+		.mime = mime,
+		.inlineThumbnail = InlineImageLocation{
 			inlineThumbnailBytes,
 			(inlineThumbnailIsPath == 1),
 		},
-		ImageWithLocation{
+		.thumbnail = ImageWithLocation{
 			.location = *thumb,
 			.bytesCount = thumbnailByteSize
 		},
-		ImageWithLocation{
+		.videoThumbnail = ImageWithLocation{
 			.location = *videoThumb,
 			.bytesCount = videoThumbnailByteSize
 		},
-		(isPremiumSticker == 1),
-		dc,
-		int64(uint32(size)));
+		.isPremiumSticker = (isPremiumSticker == 1),
+		.dc = dc,
+		.size = int64(uint32(size)),
+	};
+}
+
+DocumentData *Document::readFromStreamHelper(
+		not_null<Main::Session*> session,
+		int streamAppVersion,
+		QDataStream &stream,
+		const StickerSetInfo *info) {
+	const auto parsed = parseFromStreamHelper(
+		streamAppVersion,
+		stream,
+		info);
+	return parsed ? readFromParsed(session, *parsed).get() : nullptr;
+}
+
+auto Document::parseStickerFromStream(
+		int streamAppVersion,
+		QDataStream &stream,
+		const StickerSetInfo &info) -> std::optional<Parsed> {
+	return parseFromStreamHelper(streamAppVersion, stream, &info);
+}
+
+not_null<DocumentData*> Document::readFromParsed(
+		not_null<Main::Session*> session,
+		const Parsed &parsed) {
+	return session->data().document(
+		parsed.id,
+		parsed.access,
+		parsed.fileReference,
+		parsed.date,
+		parsed.attributes,
+		parsed.mime,
+		parsed.inlineThumbnail,
+		parsed.thumbnail,
+		parsed.videoThumbnail,
+		parsed.isPremiumSticker,
+		parsed.dc,
+		parsed.size);
 }
 
 DocumentData *Document::readStickerFromStream(
@@ -24,7 +24,31 @@ public:
 		QString shortName;
 	};
 
+	// Document fields as read from the stream, without touching the
+	// session, so that they can be parsed on any thread.
+	struct Parsed {
+		DocumentId id = 0;
+		uint64 access = 0;
+		QByteArray fileReference;
+		TimeId date = 0;
+		QVector<MTPDocumentAttribute> attributes;
+		QString mime;
+		InlineImageLocation inlineThumbnail;
+		ImageWithLocation thumbnail;
+		ImageWithLocation videoThumbnail;
+		bool isPremiumSticker = false;
+		int32 dc = 0;
+		int64 size = 0;
+	};
+
 	static void writeToStream(QDataStream &stream, DocumentData *document);
+	[[nodiscard]] static std::optional<Parsed> parseStickerFromStream(
+		int streamAppVersion,
+		QDataStream &stream,
+		const StickerSetInfo &info);
+	static not_null<DocumentData*> readFromParsed(
+		not_null<Main::Session*> session,
+		const Parsed &parsed);
 	static DocumentData *readStickerFromStream(
 		not_null<Main::Session*> session,
 		int streamAppVersion,
@@ -37,6 +61,10 @@ public:
 	static int sizeInStream(DocumentData *document);
 
 private:
+	static std::optional<Parsed> parseFromStreamHelper(
+		int streamAppVersion,
+		QDataStream &stream,
+		const StickerSetInfo *info);
 	static DocumentData *readFromStreamHelper(
 		not_null<Main::Session*> session,
 		int streamAppVersion,
@@ -28,6 +28,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/core_settings.h"
 #include "core/file_location.h"
+#include "core/startup_trace.h"
 #include "data/components/recent_peers.h"
 #include "data/components/top_peers.h"
 #include "data/stickers/data_stickers.h"
@@ -38,6 +39,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/export_settings.h"
 #include "webview/webview_interface.h"
 #include "window/themes/window_theme.h"
+#include "base/random.h"
 
 namespace Storage {
 namespace {
@@ -48,6 +50,8 @@ using Database = Cache::Database;
 constexpr auto kDelayedWriteTimeout = crl::time(1000);
 constexpr auto kWriteSearchSuggestionsDelay = 5 * crl::time(1000);
 constexpr auto kMaxSavedPlaybackPositions = 256;
+constexpr auto kLocationsJournalMinCompactSize = 256 * 1024;
+constexpr auto kDownloadsPatchMergeGap = 16;
 
 constexpr auto kStickersVersionTag = quint32(-1);
 constexpr auto kStickersSerializeVersion = 4;
@@ -100,6 +104,52 @@ enum { // Local Storage Keys
 	lskMediaLastPlaybackPositions = 0x1c, // no data
 };
 
+enum class LocationsJournalRecord : quint32 {
+	Locations = 0x01, // data: MediaKey, count, locations
+	Alias = 0x02, // data: MediaKey, MediaKey
+	Downloads = 0x03, // data: QByteArray
+	DownloadsPatch = 0x04, // data: size, count, (offset, QByteArray)
+};
+
+struct DownloadsPatchPart {
+	int offset = 0;
+	QByteArray bytes;
+};
+
+// Downloads are added at the end of the list and removed one by one,
+// so comparing the bytes at the same offsets gives a short patch.
+[[nodiscard]] std::vector<DownloadsPatchPart> PrepareDownloadsPatch(
+		const QByteArray &was,
+		const QByteArray &now) {
+	auto result = std::vector<DownloadsPatchPart>();
+	const auto common = int(std::min(was.size(), now.size()));
+	auto from = -1;
+	auto equal = 0;
+	const auto push = [&](int till) {
+		result.push_back({ from, now.mid(from, till - from) });
+		from = -1;
+	};
+	for (auto i = 0; i != common; ++i) {
+		if (was[i] != now[i]) {
+			if (from < 0) {
+				from = i;
+			}
+			equal = 0;
+		} else if (from >= 0 && ++equal == kDownloadsPatchMergeGap) {
+			push(i + 1 - equal);
+		}
+	}
+	if (now.size() > common) {
+		if (from < 0) {
+			from = common;
+		}
+		push(now.size());
+	} else if (from >= 0) {
+		push(common - equal);
+	}
+	return result;
+}
+
 auto EmptyMessageDraftSources()
 -> const base::flat_map<Data::DraftKey, MessageDraftSource> & {
 	static const auto result = base::flat_map<
@@ -134,6 +184,216 @@ auto EmptyMessageDraftSources()
 	return cWorkingDir() + u"tdata/tdld/"_q;
 }
 
+[[nodiscard]] std::optional<DecryptedFile> ReadDecryptedMap(
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key) {
+	FileReadDescriptor mapData;
+	if (!ReadFile(mapData, u"map"_q, basePath)) {
+		return std::nullopt;
+	}
+	QByteArray legacySalt, legacyKeyEncrypted, mapEncrypted;
+	mapData.stream >> legacySalt >> legacyKeyEncrypted >> mapEncrypted;
+
+	EncryptedDescriptor map;
+	if (!CheckStreamStatus(mapData.stream)
+		|| !DecryptLocal(map, mapEncrypted, key)) {
+		return std::nullopt;
+	}
+	return DecryptedFile{
+		.version = mapData.version,
+		.data = map.data,
+		.position = map.buffer.pos(),
+	};
+}
+
+struct ParsedStickerSet {
+	uint64 id = 0;
+	uint64 accessHash = 0;
+	uint64 hash = 0;
+	DocumentId thumbnailDocumentId = 0;
+	QString title;
+	QString shortName;
+	int count = 0; // Negative for disabled not loaded sets.
+	Data::StickersSetFlags flags;
+	TimeId installDate = 0;
+	qint32 thumbnailType = qint32(StickerType::Webp);
+	bool legacyThumbnailType = false;
+	ImageLocation thumbnail;
+	std::vector<Serialize::Document::Parsed> stickers;
+	std::vector<TimeId> dates;
+	std::vector<std::pair<QString, std::vector<DocumentId>>> emoji;
+};
+
+struct ParsedStickerSets {
+	bool readFailed = false;
+	bool parseFailed = false;
+	std::vector<ParsedStickerSet> sets;
+	Data::StickersSetsOrder order;
+};
+
+// Doesn't touch the session, so it can run on any thread.
+[[nodiscard]] ParsedStickerSets ReadStickerSetsFile(
+		const FileKey &key,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &localKey,
+		bool withOrder) {
+	auto result = ParsedStickerSets();
+	FileReadDescriptor stickers;
+	if (!ReadEncryptedFile(stickers, key, basePath, localKey)) {
+		result.readFailed = true;
+		return result;
+	}
+	const auto failed = [&] {
+		result.parseFailed = true;
+		result.sets.clear();
+		result.order.clear();
+		return std::move(result);
+	};
+
+	quint32 versionTag = 0;
+	qint32 version = 0;
+	stickers.stream >> versionTag >> version;
+	if (versionTag != kStickersVersionTag || version < 2) {
+		// Old data, without sticker set thumbnails.
+		return failed();
+	}
+	qint32 count = 0;
+	stickers.stream >> count;
+	if (!CheckStreamStatus(stickers.stream)
+		|| (count < 0)
+		|| (count > kMaxSavedStickerSetsCount)) {
+		return failed();
+	}
+	result.sets.reserve(count);
+	for (auto i = 0; i != count; ++i) {
+		auto set = ParsedStickerSet();
+		quint64 setId = 0, setAccessHash = 0, setHash = 0;
+		quint64 setThumbnailDocumentId = 0;
+		qint32 scnt = 0;
+		qint32 setInstallDate = 0;
+		qint32 setFlagsValue = 0;
+
+		stickers.stream
+			>> setId
+			>> setAccessHash
+			>> setHash
+			>> set.title
+			>> set.shortName
+			>> scnt
+			>> setFlagsValue
+			>> setInstallDate;
+		if (version > 2) {
+			stickers.stream >> setThumbnailDocumentId;
+			if (version > 3) {
+				stickers.stream >> set.thumbnailType;
+			}
+		}
+
+		constexpr auto kLegacyFlagWebm = (1 << 8);
+		if ((version < 4) && (setFlagsValue & kLegacyFlagWebm)) {
+			set.thumbnailType = qint32(StickerType::Webm);
+		}
+		const auto thumbnail = Serialize::readImageLocation(
+			stickers.version,
+			stickers.stream);
+		if (!thumbnail || !CheckStreamStatus(stickers.stream)) {
+			return failed();
+		} else if (thumbnail->valid() && thumbnail->isLegacy()) {
+			// No thumb_version information in legacy location.
+			return failed();
+		} else if (!setId) {
+			continue;
+		}
+		set.id = setId;
+		set.accessHash = setAccessHash;
+		set.hash = setHash;
+		set.thumbnailDocumentId = setThumbnailDocumentId;
+		set.count = scnt;
+		set.flags = Data::StickersSetFlags::from_raw(setFlagsValue);
+		set.installDate = setInstallDate;
+		set.thumbnail = *thumbnail;
+		set.legacyThumbnailType = (version < 4);
+
+		if (scnt < 0) { // disabled not loaded set
+			result.sets.push_back(std::move(set));
+			continue;
+		}
+
+		Serialize::Document::StickerSetInfo info(
+			setId,
+			setAccessHash,
+			set.shortName);
+		set.stickers.reserve(scnt);
+		for (int32 j = 0; j < scnt; ++j) {
+			auto document = Serialize::Document::parseStickerFromStream(
+				stickers.version,
+				stickers.stream, info);
+			if (!CheckStreamStatus(stickers.stream)) {
+				return failed();
+			} else if (document) {
+				set.stickers.push_back(std::move(*document));
+			}
+		}
+
+		qint32 datesCount = 0;
+		stickers.stream >> datesCount;
+		if (datesCount > 0) {
+			if (datesCount != scnt) {
+				return failed();
+			}
+			set.dates.reserve(datesCount);
+			for (auto i = 0; i != datesCount; ++i) {
+				qint32 date = 0;
+				stickers.stream >> date;
+				set.dates.push_back(TimeId(date));
+			}
+		}
+
+		qint32 emojiCount = 0;
+		stickers.stream >> emojiCount;
+		if (!CheckStreamStatus(stickers.stream) || emojiCount < 0) {
+			return failed();
+		}
+		set.emoji.reserve(emojiCount);
+		for (int32 j = 0; j < emojiCount; ++j) {
+			QString emojiString;
+			qint32 stickersCount;
+			stickers.stream >> emojiString >> stickersCount;
+			auto pack = std::vector<DocumentId>();
+			pack.reserve(std::max(stickersCount, 0));
+			for (int32 k = 0; k < stickersCount; ++k) {
+				quint64 id;
+				stickers.stream >> id;
+				pack.push_back(id);
+			}
+			set.emoji.emplace_back(emojiString, std::move(pack));
+		}
+		result.sets.push_back(std::move(set));
+	}
+
+	// Read orders of installed and featured stickers.
+	if (withOrder) {
+		auto outOrderCount = quint32();
+		stickers.stream >> outOrderCount;
+		if (!CheckStreamStatus(stickers.stream) || outOrderCount > 1000) {
+			return failed();
+		}
+		result.order.reserve(outOrderCount);
+		for (auto i = 0; i != outOrderCount; ++i) {
+			auto value = uint64();
+			stickers.stream >> value;
+			if (!CheckStreamStatus(stickers.stream)) {
+				return failed();
+			}
+			result.order.push_back(value);
+		}
+	}
+	if (!CheckStreamStatus(stickers.stream)) {
+		return failed();
+	}
+	return result;
+}
+
 } // namespace
 
 Account::Account(not_null<Main::Account*> owner, const QString &dataName)
@@ -185,7 +445,9 @@ std::unique_ptr<MTP::Config> Account::start(MTP::AuthKeyPtr localKey) {
 	_localKey = std::move(localKey);
 	readMapWith(_localKey);
 	clearLegacyFiles();
-	return readMtpConfig();
+	auto result = readMtpConfig();
+	_preloadedStart.clear();
+	return result;
 }
 
 void Account::startAdded(MTP::AuthKeyPtr localKey) {
@@ -258,49 +520,25 @@ base::flat_set<QString> Account::collectGoodNames() const {
 	for (const auto &value : keys) {
 		push(value);
 	}
+	if (_locationsKey) {
+		result.emplace(ToFilePart(_locationsKey) + 'j');
+	}
 	return result;
 }
 
 Account::ReadMapResult Account::readMapWith(
 		MTP::AuthKeyPtr localKey,
 		const QByteArray &legacyPasscode) {
+	const auto trace = Core::StartupTrace::Span(
+		"Storage::Account::readMapWith");
 	auto ms = crl::now();
 
-	FileReadDescriptor mapData;
-	if (!ReadFile(mapData, u"map"_q, _basePath)) {
-		return ReadMapResult::Failed;
-	}
-	LOG(("App Info: reading map..."));
-
-	QByteArray legacySalt, legacyKeyEncrypted, mapEncrypted;
-	mapData.stream >> legacySalt >> legacyKeyEncrypted >> mapEncrypted;
-	if (!CheckStreamStatus(mapData.stream)) {
-		return ReadMapResult::Failed;
-	}
-	if (!localKey) {
-		if (legacySalt.size() != LocalEncryptSaltSize) {
-			LOG(("App Error: bad salt in map file, size: %1").arg(legacySalt.size()));
-			return ReadMapResult::Failed;
+	FileReadDescriptor map;
+	if (!localKey || !readPreloadedFile(map, u"map"_q)) {
+		const auto result = readMapFile(map, localKey, legacyPasscode);
+		if (result != ReadMapResult::Success) {
+			return result;
 		}
-		auto legacyPasscodeKey = CreateLegacyLocalKey(legacyPasscode, legacySalt);
-
-		EncryptedDescriptor keyData;
-		if (!DecryptLocal(keyData, legacyKeyEncrypted, legacyPasscodeKey)) {
-			LOG(("App Info: could not decrypt pass-protected key from map file, maybe bad password..."));
-			return ReadMapResult::IncorrectPasscode;
-		}
-		auto key = Serialize::read<MTP::AuthKey::Data>(keyData.stream);
-		if (keyData.stream.status() != QDataStream::Ok || !keyData.stream.atEnd()) {
-			LOG(("App Error: could not read pass-protected key from map file"));
-			return ReadMapResult::Failed;
-		}
-		localKey = std::make_shared<MTP::AuthKey>(key);
-	}
-
-	EncryptedDescriptor map;
-	if (!DecryptLocal(map, mapEncrypted, localKey)) {
-		LOG(("App Error: could not decrypt map."));
-		return ReadMapResult::Failed;
 	}
 	LOG(("App Info: reading encrypted map..."));
 
@@ -482,7 +720,7 @@ Account::ReadMapResult Account::readMapWith(
 	_roundPlaceholderKey = roundPlaceholderKey;
 	_inlineBotsDownloadsKey = inlineBotsDownloadsKey;
 	_mediaLastPlaybackPositionsKey = mediaLastPlaybackPositionsKey;
-	_oldMapVersion = mapData.version;
+	_oldMapVersion = map.version;
 	_webviewStorageIdBots.token = webviewStorageTokenBots;
 	_webviewStorageIdOther.token = webviewStorageTokenOther;
 
@@ -517,6 +755,56 @@ Account::ReadMapResult Account::readMapWith(
 	return ReadMapResult::Success;
 }
 
+Account::ReadMapResult Account::readMapFile(
+		FileReadDescriptor &result,
+		MTP::AuthKeyPtr &localKey,
+		const QByteArray &legacyPasscode) {
+	FileReadDescriptor mapData;
+	if (!ReadFile(mapData, u"map"_q, _basePath)) {
+		return ReadMapResult::Failed;
+	}
+	LOG(("App Info: reading map..."));
+
+	QByteArray legacySalt, legacyKeyEncrypted, mapEncrypted;
+	mapData.stream >> legacySalt >> legacyKeyEncrypted >> mapEncrypted;
+	if (!CheckStreamStatus(mapData.stream)) {
+		return ReadMapResult::Failed;
+	}
+	if (!localKey) {
+		if (legacySalt.size() != LocalEncryptSaltSize) {
+			LOG(("App Error: bad salt in map file, size: %1").arg(legacySalt.size()));
+			return ReadMapResult::Failed;
+		}
+		auto legacyPasscodeKey = CreateLegacyLocalKey(legacyPasscode, legacySalt);
+
+		EncryptedDescriptor keyData;
+		if (!DecryptLocal(keyData, legacyKeyEncrypted, legacyPasscodeKey)) {
+			LOG(("App Info: could not decrypt pass-protected key from map file, maybe bad password..."));
+			return ReadMapResult::IncorrectPasscode;
+		}
+		auto key = Serialize::read<MTP::AuthKey::Data>(keyData.stream);
+		if (keyData.stream.status() != QDataStream::Ok || !keyData.stream.atEnd()) {
+			LOG(("App Error: could not read pass-protected key from map file"));
+			return ReadMapResult::Failed;
+		}
+		localKey = std::make_shared<MTP::AuthKey>(key);
+	}
+
+	EncryptedDescriptor map;
+	if (!DecryptLocal(map, mapEncrypted, localKey)) {
+		LOG(("App Error: could not decrypt map."));
+		return ReadMapResult::Failed;
+	}
+	LOG(("App Info: reading encrypted map..."));
+
+	OpenDecryptedFile(result, DecryptedFile{
+		.version = mapData.version,
+		.data = map.data,
+		.position = map.buffer.pos(),
+	});
+	return ReadMapResult::Success;
+}
+
 void Account::writeMapDelayed() {
 	_mapChanged = true;
 	_writeMapTimer.callOnce(kDelayedWriteTimeout);
@@ -717,6 +1005,10 @@ void Account::reset() {
 	_fileLocations.clear();
 	_fileLocationPairs.clear();
 	_fileLocationAliases.clear();
+	_locationsJournalKeys.clear();
+	_locationsJournalAliases.clear();
+	_locationsJournalSalt = 0;
+	_locationsJournalSize = _locationsSnapshotSize = 0;
 	_downloadsSerialize = nullptr;
 	_downloadsSerialized = QByteArray();
 	_cacheTotalSizeLimit = Database::Settings().totalSizeLimit;
@@ -773,76 +1065,222 @@ void Account::writeLocations() {
 	}
 	_locationsChanged = false;
 
+	auto downloadsWas = std::optional<QByteArray>();
 	if (_downloadsSerialize) {
 		if (auto serialized = _downloadsSerialize()) {
-			_downloadsSerialized = std::move(*serialized);
+			downloadsWas = std::exchange(
+				_downloadsSerialized,
+				std::move(*serialized));
 		}
 	}
 	if (_fileLocations.isEmpty() && _downloadsSerialized.isEmpty()) {
+		_locationsJournalKeys.clear();
+		_locationsJournalAliases.clear();
+		_locationsJournalSalt = 0;
 		if (_locationsKey) {
 			ClearKey(_locationsKey, _basePath);
 			_locationsKey = 0;
 			writeMapDelayed();
 		}
-	} else {
-		if (!_locationsKey) {
-			_locationsKey = GenerateKey(_basePath);
-			writeMapQueued();
-		}
-		quint32 size = 0;
-		for (auto i = _fileLocations.cbegin(), e = _fileLocations.cend(); i != e; ++i) {
-			// location + type + namelen + name
-			size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(i.value().name());
-			if (AppVersion > 9013) {
-				// bookmark
-				size += Serialize::bytearraySize(i.value().bookmark());
-			}
-			// date + size
-			size += Serialize::dateTimeSize() + sizeof(quint32);
+	} else if (!writeLocationsJournal(downloadsWas)) {
+		writeLocationsSnapshot();
+	}
+}
+
+bool Account::writeLocationsJournal(
+		const std::optional<QByteArray> &downloadsWas) {
+	if (!_locationsKey || !_locationsJournalSalt) {
+		return false;
+	}
+	const auto locationSize = [](const Core::FileLocation &location) {
+		return Serialize::stringSize(location.name())
+			+ Serialize::bytearraySize(location.bookmark())
+			+ Serialize::dateTimeSize()
+			+ sizeof(quint32);
+	};
+	const auto keySize = sizeof(quint64) * 2;
+	auto size = uint32(0);
+	for (const auto &key : _locationsJournalKeys) {
+		size += sizeof(quint32) + keySize + sizeof(quint32);
+		for (const auto &location : _fileLocations.values(key)) {
+			size += locationSize(location);
+		}
+	}
+	size += _locationsJournalAliases.size()
+		* (sizeof(quint32) + keySize * 2);
+	const auto downloadsChanged = downloadsWas
+		&& (*downloadsWas != _downloadsSerialized);
+	const auto downloadsPatch = downloadsChanged
+		? PrepareDownloadsPatch(*downloadsWas, _downloadsSerialized)
+		: std::vector<DownloadsPatchPart>();
+	auto downloadsPatchSize = uint32(sizeof(quint32) * 3);
+	for (const auto &part : downloadsPatch) {
+		downloadsPatchSize += sizeof(quint32)
+			+ Serialize::bytearraySize(part.bytes);
+	}
+	const auto downloadsFullSize = uint32(sizeof(quint32)
+		+ Serialize::bytearraySize(_downloadsSerialized));
+	const auto downloadsFull = (downloadsPatchSize >= downloadsFullSize);
+	if (downloadsChanged) {
+		size += downloadsFull ? downloadsFullSize : downloadsPatchSize;
+	}
+	if (!size) {
+		return true;
+	} else if (_locationsJournalSize + size > std::max(
+			int64(kLocationsJournalMinCompactSize),
+			_locationsSnapshotSize)) {
+		return false;
+	}
+
+	EncryptedDescriptor data(size);
+	for (const auto &key : _locationsJournalKeys) {
+		const auto locations = _fileLocations.values(key);
+		data.stream
+			<< quint32(LocationsJournalRecord::Locations)
+			<< quint64(key.first)
+			<< quint64(key.second)
+			<< quint32(locations.size());
+		for (const auto &location : locations) {
+			data.stream
+				<< location.name()
+				<< location.bookmark()
+				<< location.modified
+				<< quint32(location.size);
+		}
+	}
+	for (const auto &[key, value] : _locationsJournalAliases) {
+		data.stream
+			<< quint32(LocationsJournalRecord::Alias)
+			<< quint64(key.first)
+			<< quint64(key.second)
+			<< quint64(value.first)
+			<< quint64(value.second);
+	}
+	if (downloadsChanged && downloadsFull) {
+		data.stream
+			<< quint32(LocationsJournalRecord::Downloads)
+			<< _downloadsSerialized;
+	} else if (downloadsChanged) {
+		data.stream
+			<< quint32(LocationsJournalRecord::DownloadsPatch)
+			<< quint32(_downloadsSerialized.size())
+			<< quint32(downloadsPatch.size());
+		for (const auto &part : downloadsPatch) {
+			data.stream << quint32(part.offset) << part.bytes;
 		}
+	}
+	_locationsJournalKeys.clear();
+	_locationsJournalAliases.clear();
+	_locationsJournalSize += AppendJournal(
+		_locationsKey,
+		_basePath,
+		data,
+		_localKey,
+		locationsJournalFailedCallback(true));
+	return true;
+}
 
-		//end mark
-		size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(QString());
+void Account::writeLocationsSnapshot() {
+	_locationsJournalKeys.clear();
+	_locationsJournalAliases.clear();
+	if (!_locationsKey) {
+		_locationsKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	quint32 size = 0;
+	for (auto i = _fileLocations.cbegin(), e = _fileLocations.cend(); i != e; ++i) {
+		// location + type + namelen + name
+		size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(i.value().name());
 		if (AppVersion > 9013) {
-			size += Serialize::bytearraySize(QByteArray());
+			// bookmark
+			size += Serialize::bytearraySize(i.value().bookmark());
 		}
+		// date + size
 		size += Serialize::dateTimeSize() + sizeof(quint32);
+	}
 
-		size += sizeof(quint32); // aliases count
-		for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
-			// alias + location
-			size += sizeof(quint64) * 2 + sizeof(quint64) * 2;
-		}
+	//end mark
+	size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(QString());
+	if (AppVersion > 9013) {
+		size += Serialize::bytearraySize(QByteArray());
+	}
+	size += Serialize::dateTimeSize() + sizeof(quint32);
 
-		size += sizeof(quint32); // legacy webLocationsCount
-		size += Serialize::bytearraySize(_downloadsSerialized);
+	size += sizeof(quint32); // aliases count
+	for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
+		// alias + location
+		size += sizeof(quint64) * 2 + sizeof(quint64) * 2;
+	}
 
-		EncryptedDescriptor data(size);
-		auto legacyTypeField = 0;
-		for (auto i = _fileLocations.cbegin(); i != _fileLocations.cend(); ++i) {
-			data.stream << quint64(i.key().first) << quint64(i.key().second) << quint32(legacyTypeField) << i.value().name();
-			if (AppVersion > 9013) {
-				data.stream << i.value().bookmark();
-			}
-			data.stream << i.value().modified << quint32(i.value().size);
-		}
+	size += sizeof(quint32); // legacy webLocationsCount
+	size += Serialize::bytearraySize(_downloadsSerialized);
+	size += sizeof(quint64); // journal salt
 
-		data.stream << quint64(0) << quint64(0) << quint32(0) << QString();
+	EncryptedDescriptor data(size);
+	auto legacyTypeField = 0;
+	for (auto i = _fileLocations.cbegin(); i != _fileLocations.cend(); ++i) {
+		data.stream << quint64(i.key().first) << quint64(i.key().second) << quint32(legacyTypeField) << i.value().name();
 		if (AppVersion > 9013) {
-			data.stream << QByteArray();
+			data.stream << i.value().bookmark();
 		}
-		data.stream << QDateTime::currentDateTime() << quint32(0);
+		data.stream << i.value().modified << quint32(i.value().size);
+	}
 
-		data.stream << quint32(_fileLocationAliases.size());
-		for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
-			data.stream << quint64(i.key().first) << quint64(i.key().second) << quint64(i.value().first) << quint64(i.value().second);
-		}
+	data.stream << quint64(0) << quint64(0) << quint32(0) << QString();
+	if (AppVersion > 9013) {
+		data.stream << QByteArray();
+	}
+	data.stream << QDateTime::currentDateTime() << quint32(0);
+
+	data.stream << quint32(_fileLocationAliases.size());
+	for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
+		data.stream << quint64(i.key().first) << quint64(i.key().second) << quint64(i.value().first) << quint64(i.value().second);
+	}
 
-		data.stream << quint32(0) << _downloadsSerialized;
+	// Older versions ignore the trailing salt and the journal.
+	_locationsJournalSalt = base::RandomValue<uint64>();
+	data.stream
+		<< quint32(0)
+		<< _downloadsSerialized
+		<< quint64(_locationsJournalSalt);
 
+	{
 		FileWriteDescriptor file(_locationsKey, _basePath);
 		file.writeEncrypted(data, _localKey);
 	}
+	_locationsSnapshotSize = data.data.size();
+
+	// Queued after the snapshot, so it is written to disk before.
+	StartJournal(
+		_locationsKey,
+		_basePath,
+		_locationsJournalSalt,
+		locationsJournalFailedCallback(false));
+	_locationsJournalSize = 0;
+}
+
+Fn<void()> Account::locationsJournalFailedCallback(bool recordsLost) {
+	return [=, weak = base::make_weak(_owner), salt = _locationsJournalSalt] {
+		crl::on_main(weak, [=] {
+			if (_locationsJournalSalt && _locationsJournalSalt != salt) {
+				// A new snapshot with all the changes was written already.
+				return;
+			}
+			_locationsJournalSalt = 0;
+			if (recordsLost) {
+				writeLocationsDelayed();
+			}
+		});
+	};
+}
+
+void Account::locationChanged(MediaKey location) {
+	_locationsJournalKeys.emplace(location);
+}
+
+void Account::aliasChanged(MediaKey location, MediaKey target) {
+	_fileLocationAliases.insert(location, target);
+	_locationsJournalAliases[location] = target;
 }
 
 void Account::writeLocationsQueued() {
@@ -919,6 +1357,127 @@ void Account::readLocations() {
 			}
 		}
 	}
+	_locationsSnapshotSize = locations.data.size();
+
+	auto salt = quint64();
+	if (!locations.stream.atEnd()) {
+		locations.stream >> salt;
+	}
+	readLocationsJournal(salt);
+}
+
+void Account::readLocationsJournal(uint64 salt) {
+	if (!salt) {
+		// Written by an older version, start the journal from a snapshot.
+		writeLocationsDelayed();
+		return;
+	}
+	const auto apply = [&](EncryptedDescriptor &record) {
+		auto &stream = record.stream;
+		while (!stream.atEnd()) {
+			quint32 type = 0;
+			stream >> type;
+			switch (LocationsJournalRecord(type)) {
+			case LocationsJournalRecord::Locations: {
+				quint64 first = 0, second = 0;
+				quint32 count = 0;
+				stream >> first >> second >> count;
+				const auto key = MediaKey(first, second);
+				auto list = std::vector<Core::FileLocation>();
+				list.reserve(count);
+				for (auto i = quint32(); i != count; ++i) {
+					auto location = Core::FileLocation();
+					auto bookmark = QByteArray();
+					quint32 size = 0;
+					stream
+						>> location.fname
+						>> bookmark
+						>> location.modified
+						>> size;
+					location.setBookmark(bookmark);
+					location.size = int64(size);
+					list.push_back(std::move(location));
+				}
+				if (!CheckStreamStatus(stream)) {
+					return;
+				}
+				for (const auto &location : _fileLocations.values(key)) {
+					const auto i = _fileLocationPairs.constFind(location.fname);
+					if (i != _fileLocationPairs.cend()
+						&& i.value().first == key) {
+						_fileLocationPairs.erase(i);
+					}
+				}
+				_fileLocations.remove(key);
+
+				// QMultiMap::values() lists the latest insertion first.
+				for (const auto &location : list | ranges::views::reverse) {
+					_fileLocations.insert(key, location);
+					if (!location.inMediaCache()) {
+						_fileLocationPairs.insert(
+							location.fname,
+							{ key, location });
+					}
+				}
+			} break;
+			case LocationsJournalRecord::Alias: {
+				quint64 kfirst = 0, ksecond = 0, vfirst = 0, vsecond = 0;
+				stream >> kfirst >> ksecond >> vfirst >> vsecond;
+				if (!CheckStreamStatus(stream)) {
+					return;
+				}
+				_fileLocationAliases.insert(
+					MediaKey(kfirst, ksecond),
+					MediaKey(vfirst, vsecond));
+			} break;
+			case LocationsJournalRecord::Downloads: {
+				auto downloads = QByteArray();
+				stream >> downloads;
+				if (!CheckStreamStatus(stream)) {
+					return;
+				}
+				_downloadsSerialized = std::move(downloads);
+			} break;
+			case LocationsJournalRecord::DownloadsPatch: {
+				quint32 size = 0, count = 0;
+				stream >> size >> count;
+				auto patched = _downloadsSerialized;
+				patched.resize(size);
+				for (auto i = quint32(); i != count; ++i) {
+					quint32 offset = 0;
+					auto bytes = QByteArray();
+					stream >> offset >> bytes;
+					if (!CheckStreamStatus(stream)
+						|| offset > size
+						|| quint32(bytes.size()) > size - offset) {
+						return;
+					}
+					patched.replace(offset, bytes.size(), bytes);
+				}
+				if (!CheckStreamStatus(stream)) {
+					return;
+				}
+				_downloadsSerialized = std::move(patched);
+			} break;
+			default:
+				LOG(("App Error: unknown locations journal record %1."
+					).arg(type));
+				return;
+			}
+		}
+	};
+	const auto size = ReadJournal(
+		_locationsKey,
+		_basePath,
+		_localKey,
+		salt,
+		apply);
+	if (size < 0) {
+		writeLocationsDelayed();
+	} else {
+		_locationsJournalSalt = salt;
+		_locationsJournalSize = size;
+	}
 }
 
 void Account::updateDownloads(
@@ -1082,7 +1641,8 @@ void Account::readMtpData() {
 	auto context = prepareReadSettingsContext();
 
 	FileReadDescriptor mtp;
-	if (!ReadEncryptedFile(mtp, ToFilePart(_dataNameKey), BaseGlobalPath(), _localKey)) {
+	if (!readPreloadedFile(mtp, ToFilePart(_dataNameKey))
+		&& !ReadEncryptedFile(mtp, ToFilePart(_dataNameKey), BaseGlobalPath(), _localKey)) {
 		if (_localKey) {
 			Local::readOldMtpData(true, context);
 			applyReadContext(std::move(context));
@@ -1122,7 +1682,8 @@ std::unique_ptr<MTP::Config> Account::readMtpConfig() {
 	Expects(_localKey != nullptr);
 
 	FileReadDescriptor file;
-	if (!ReadEncryptedFile(file, "config", _basePath, _localKey)) {
+	if (!readPreloadedFile(file, u"config"_q)
+		&& !ReadEncryptedFile(file, "config", _basePath, _localKey)) {
 		return nullptr;
 	}
 
@@ -1663,7 +2224,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 		if (i != _fileLocationPairs.cend()) {
 			if (i.value().second == local) {
 				if (i.value().first != location) {
-					_fileLocationAliases.insert(location, i.value().first);
+					aliasChanged(location, i.value().first);
 					writeLocationsQueued();
 				}
 				return;
@@ -1672,6 +2233,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 				for (auto j = _fileLocations.find(i.value().first), e = _fileLocations.end(); (j != e) && (j.key() == i.value().first); ++j) {
 					if (j.value() == i.value().second) {
 						_fileLocations.erase(j);
+						locationChanged(i.value().first);
 						break;
 					}
 				}
@@ -1688,6 +2250,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 		}
 	}
 	_fileLocations.insert(location, local);
+	locationChanged(location);
 	writeLocationsQueued();
 }
 
@@ -1699,6 +2262,7 @@ void Account::removeFileLocation(MediaKey location) {
 	while (i != _fileLocations.end() && (i.key() == location)) {
 		i = _fileLocations.erase(i);
 	}
+	locationChanged(location);
 	writeLocationsQueued();
 }
 
@@ -1712,6 +2276,7 @@ Core::FileLocation Account::readFileLocation(MediaKey location) {
 		if (!i.value().inMediaCache() && !i.value().check()) {
 			_fileLocationPairs.remove(i.value().fname);
 			i = _fileLocations.erase(i);
+			locationChanged(location);
 			writeLocationsDelayed();
 			continue;
 		}
@@ -1938,86 +2503,134 @@ void Account::writeStickerSets(
 	file.writeEncrypted(data, _localKey);
 }
 
+struct Account::PreloadedFile {
+	crl::semaphore ready;
+	std::optional<DecryptedFile> result;
+};
+
+struct Account::PreloadedStickerSets {
+	crl::semaphore ready;
+	ParsedStickerSets result;
+};
+
+void Account::preloadStickerSets() {
+	const auto keys = {
+		std::make_pair(_installedStickersKey, true),
+		std::make_pair(_installedMasksKey, true),
+		std::make_pair(_installedCustomEmojiKey, true),
+		std::make_pair(_featuredStickersKey, true),
+		std::make_pair(_featuredCustomEmojiKey, true),
+		std::make_pair(_recentStickersKey, false),
+		std::make_pair(_recentMasksKey, false),
+		std::make_pair(_favedStickersKey, false),
+	};
+	for (const auto &[key, withOrder] : keys) {
+		if (!key || _preloadedSets.contains(key)) {
+			continue;
+		}
+		const auto sets = std::make_shared<PreloadedStickerSets>();
+		_preloadedSets.emplace(key, sets);
+		crl::async([=,
+				key = key,
+				withOrder = withOrder,
+				basePath = _basePath,
+				localKey = _localKey] {
+			sets->result = ReadStickerSetsFile(
+				key,
+				basePath,
+				localKey,
+				withOrder);
+			sets->ready.release();
+		});
+	}
+}
+
+void Account::preloadStart(MTP::AuthKeyPtr localKey) {
+	Expects(localKey != nullptr);
+
+	const auto preload = [&](
+			const QString &name,
+			Fn<std::optional<DecryptedFile>()> read) {
+		const auto file = std::make_shared<PreloadedFile>();
+		_preloadedStart.emplace(name, file);
+		crl::async([=] {
+			file->result = read();
+			file->ready.release();
+		});
+	};
+	const auto basePath = _basePath;
+	const auto globalPath = BaseGlobalPath();
+	preload(u"map"_q, [=] {
+		return ReadDecryptedMap(basePath, localKey);
+	});
+	preload(ToFilePart(_dataNameKey), [=, key = _dataNameKey] {
+		return ReadDecryptedFile(key, globalPath, localKey);
+	});
+	preload(u"config"_q, [=] {
+		return ReadDecryptedFile(u"config"_q, basePath, localKey);
+	});
+}
+
+bool Account::readPreloadedFile(
+		FileReadDescriptor &result,
+		const QString &name) {
+	const auto i = _preloadedStart.find(name);
+	if (i == end(_preloadedStart)) {
+		return false;
+	}
+	const auto file = i->second;
+	_preloadedStart.erase(i);
+
+	file->ready.acquire();
+	if (!file->result) {
+		return false;
+	}
+	OpenDecryptedFile(result, base::take(*file->result));
+	return true;
+}
+
 void Account::readStickerSets(
 		FileKey &stickersKey,
 		Data::StickersSetsOrder *outOrder,
 		Data::StickersSetFlags readingFlags) {
 	using SetFlag = Data::StickersSetFlag;
 
-	FileReadDescriptor stickers;
-	if (!ReadEncryptedFile(stickers, stickersKey, _basePath, _localKey)) {
+	auto parsed = [&] {
+		const auto i = _preloadedSets.find(stickersKey);
+		if (i == end(_preloadedSets)) {
+			return ReadStickerSetsFile(
+				stickersKey,
+				_basePath,
+				_localKey,
+				(outOrder != nullptr));
+		}
+		const auto preloaded = i->second;
+		_preloadedSets.erase(i);
+
+		preloaded->ready.acquire();
+		return base::take(preloaded->result);
+	}();
+	if (parsed.readFailed) {
 		ClearKey(stickersKey, _basePath);
 		stickersKey = 0;
 		writeMapDelayed();
 		return;
 	}
 
-	const auto failed = [&] {
+	if (outOrder) outOrder->clear();
+	if (parsed.parseFailed) {
 		ClearKey(stickersKey, _basePath);
 		stickersKey = 0;
-	};
-
-	auto &sets = _owner->session().data().stickers().setsRef();
-	if (outOrder) outOrder->clear();
-
-	quint32 versionTag = 0;
-	qint32 version = 0;
-	stickers.stream >> versionTag >> version;
-	if (versionTag != kStickersVersionTag || version < 2) {
-		// Old data, without sticker set thumbnails.
-		return failed();
-	}
-	qint32 count = 0;
-	stickers.stream >> count;
-	if (!CheckStreamStatus(stickers.stream)
-		|| (count < 0)
-		|| (count > kMaxSavedStickerSetsCount)) {
-		return failed();
+		return;
 	}
-	for (auto i = 0; i != count; ++i) {
-		quint64 setId = 0, setAccessHash = 0, setHash = 0;
-		quint64 setThumbnailDocumentId = 0;
-		QString setTitle, setShortName;
-		qint32 scnt = 0;
-		qint32 setInstallDate = 0;
-		Data::StickersSetFlags setFlags = 0;
-		qint32 setFlagsValue = 0;
-		qint32 setThumbnailType = qint32(StickerType::Webp);
-		ImageLocation setThumbnail;
-
-		stickers.stream
-			>> setId
-			>> setAccessHash
-			>> setHash
-			>> setTitle
-			>> setShortName
-			>> scnt
-			>> setFlagsValue
-			>> setInstallDate;
-		if (version > 2) {
-			stickers.stream >> setThumbnailDocumentId;
-			if (version > 3) {
-				stickers.stream >> setThumbnailType;
-			}
-		}
-
-		constexpr auto kLegacyFlagWebm = (1 << 8);
-		if ((version < 4) && (setFlagsValue & kLegacyFlagWebm)) {
-			setThumbnailType = qint32(StickerType::Webm);
-		}
-		const auto thumbnail = Serialize::readImageLocation(
-			stickers.version,
-			stickers.stream);
-		if (!thumbnail || !CheckStreamStatus(stickers.stream)) {
-			return failed();
-		} else if (thumbnail->valid() && thumbnail->isLegacy()) {
-			// No thumb_version information in legacy location.
-			return failed();
-		} else {
-			setThumbnail = *thumbnail;
-		}
 
-		setFlags = Data::StickersSetFlags::from_raw(setFlagsValue);
+	const auto session = &_owner->session();
+	auto &sets = session->data().stickers().setsRef();
+	for (auto &parsedSet : parsed.sets) {
+		const auto setId = parsedSet.id;
+		auto setTitle = parsedSet.title;
+		auto setFlags = parsedSet.flags;
+		auto setThumbnailType = parsedSet.thumbnailType;
 		if (setId == Data::Stickers::DefaultSetId) {
 			setTitle = tr::lng_stickers_default_set(tr::now);
 			setFlags |= SetFlag::Official | SetFlag::Special;
@@ -2031,8 +2644,6 @@ void Account::readStickerSets(
 		} else if (setId == Data::Stickers::FavedSetId) {
 			setTitle = Lang::Hard::FavedSetTitle();
 			setFlags |= SetFlag::Special;
-		} else if (!setId) {
-			continue;
 		}
 
 		auto it = sets.find(setId);
@@ -2041,48 +2652,39 @@ void Account::readStickerSets(
 			// We will set this flags from order lists when reading those stickers.
 			setFlags &= ~(SetFlag::Installed | SetFlag::Featured);
 			it = sets.emplace(setId, std::make_unique<Data::StickersSet>(
-				&_owner->session().data(),
+				&session->data(),
 				setId,
-				setAccessHash,
-				setHash,
+				parsedSet.accessHash,
+				parsedSet.hash,
 				setTitle,
-				setShortName,
+				parsedSet.shortName,
 				0,
 				setFlags,
-				setInstallDate)).first;
-			it->second->thumbnailDocumentId = setThumbnailDocumentId;
+				parsedSet.installDate)).first;
+			it->second->thumbnailDocumentId = parsedSet.thumbnailDocumentId;
 		}
 		const auto set = it->second.get();
 		const auto inputSet = set->identifier();
 		const auto fillStickers = set->stickers.isEmpty();
 
-		if (scnt < 0) { // disabled not loaded set
+		if (parsedSet.count < 0) { // disabled not loaded set
 			if (!set->count || fillStickers) {
-				set->count = -scnt;
+				set->count = -parsedSet.count;
 			}
 			continue;
 		}
 
 		if (fillStickers) {
-			set->stickers.reserve(scnt);
+			set->stickers.reserve(parsedSet.stickers.size());
 			set->count = 0;
 		}
 
-		Serialize::Document::StickerSetInfo info(
-			setId,
-			setAccessHash,
-			setShortName);
 		base::flat_set<DocumentId> read;
-		for (int32 j = 0; j < scnt; ++j) {
-			auto document = Serialize::Document::readStickerFromStream(
-				&_owner->session(),
-				stickers.version,
-				stickers.stream, info);
-			if (!CheckStreamStatus(stickers.stream)) {
-				return failed();
-			} else if (!document
-				|| !document->sticker()
-				|| read.contains(document->id)) {
+		for (const auto &parsedDocument : parsedSet.stickers) {
+			const auto document = Serialize::Document::readFromParsed(
+				session,
+				parsedDocument);
+			if (!document->sticker() || read.contains(document->id)) {
 				continue;
 			}
 			read.emplace(document->id);
@@ -2097,44 +2699,19 @@ void Account::readStickerSets(
 			}
 		}
 
-		qint32 datesCount = 0;
-		stickers.stream >> datesCount;
-		if (datesCount > 0) {
-			if (datesCount != scnt) {
-				return failed();
-			}
-			const auto fillDates
-				= ((set->id == Data::Stickers::CloudRecentSetId)
-					|| (set->id == Data::Stickers::CloudRecentAttachedSetId))
-				&& (set->stickers.size() == datesCount);
-			if (fillDates) {
-				set->dates.clear();
-				set->dates.reserve(datesCount);
-			}
-			for (auto i = 0; i != datesCount; ++i) {
-				qint32 date = 0;
-				stickers.stream >> date;
-				if (fillDates) {
-					set->dates.push_back(TimeId(date));
-				}
-			}
+		const auto fillDates = !parsedSet.dates.empty()
+			&& ((set->id == Data::Stickers::CloudRecentSetId)
+				|| (set->id == Data::Stickers::CloudRecentAttachedSetId))
+			&& (set->stickers.size() == parsedSet.dates.size());
+		if (fillDates) {
+			set->dates = std::move(parsedSet.dates);
 		}
 
-		qint32 emojiCount = 0;
-		stickers.stream >> emojiCount;
-		if (!CheckStreamStatus(stickers.stream) || emojiCount < 0) {
-			return failed();
-		}
-		for (int32 j = 0; j < emojiCount; ++j) {
-			QString emojiString;
-			qint32 stickersCount;
-			stickers.stream >> emojiString >> stickersCount;
+		for (const auto &[emojiString, ids] : parsedSet.emoji) {
 			Data::StickersPack pack;
-			pack.reserve(stickersCount);
-			for (int32 k = 0; k < stickersCount; ++k) {
-				quint64 id;
-				stickers.stream >> id;
-				const auto doc = _owner->session().data().document(id);
+			pack.reserve(ids.size());
+			for (const auto id : ids) {
+				const auto doc = session->data().document(id);
 				if (!doc->sticker()) continue;
 
 				pack.push_back(doc);
@@ -2148,7 +2725,7 @@ void Account::readStickerSets(
 		}
 
 		if (settingSet) {
-			if (version < 4
+			if (parsedSet.legacyThumbnailType
 				&& setThumbnailType == qint32(StickerType::Webp)
 				&& !set->stickers.empty()
 				&& set->stickers.front()->sticker()) {
@@ -2164,30 +2741,12 @@ void Account::readStickerSets(
 				return StickerType::Webp;
 			}();
 			set->setThumbnail(
-				ImageWithLocation{ .location = setThumbnail }, thumbType);
+				ImageWithLocation{ .location = parsedSet.thumbnail },
+				thumbType);
 		}
 	}
-
-	// Read orders of installed and featured stickers.
 	if (outOrder) {
-		auto outOrderCount = quint32();
-		stickers.stream >> outOrderCount;
-		if (!CheckStreamStatus(stickers.stream) || outOrderCount > 1000) {
-			return failed();
-		}
-		outOrder->reserve(outOrderCount);
-		for (auto i = 0; i != outOrderCount; ++i) {
-			auto value = uint64();
-			stickers.stream >> value;
-			if (!CheckStreamStatus(stickers.stream)) {
-				outOrder->clear();
-				return failed();
-			}
-			outOrder->push_back(value);
-		}
-	}
-	if (!CheckStreamStatus(stickers.stream)) {
-		return failed();
+		*outOrder = std::move(parsed.order);
 	}
 
 	// Set flags that we dropped above from the order.
@@ -71,6 +71,9 @@ public:
 	[[nodiscard]] std::unique_ptr<MTP::Config> start(
 		MTP::AuthKeyPtr localKey);
 	void startAdded(MTP::AuthKeyPtr localKey);
+
+	// Decrypts the files read by start() on a worker thread.
+	void preloadStart(MTP::AuthKeyPtr localKey);
 	[[nodiscard]] int oldMapVersion() const {
 		return _oldMapVersion;
 	}
@@ -125,6 +128,8 @@ public:
 	void writeFavedStickers();
 	void writeArchivedStickers();
 	void writeArchivedMasks();
+	// Starts reading and parsing sticker and emoji sets files in parallel.
+	void preloadStickerSets();
 	void readInstalledStickers();
 	void readFeaturedStickers();
 	void readRecentStickers();
@@ -224,15 +229,30 @@ private:
 	ReadMapResult readMapWith(
 		MTP::AuthKeyPtr localKey,
 		const QByteArray &legacyPasscode = QByteArray());
+	ReadMapResult readMapFile(
+		details::FileReadDescriptor &result,
+		MTP::AuthKeyPtr &localKey,
+		const QByteArray &legacyPasscode);
+	[[nodiscard]] bool readPreloadedFile(
+		details::FileReadDescriptor &result,
+		const QString &name);
 	void clearLegacyFiles();
 	void writeMapDelayed();
 	void writeMapQueued();
 	void writeMap();
 
 	void readLocations();
+	void readLocationsJournal(uint64 salt);
 	void writeLocations();
 	void writeLocationsQueued();
 	void writeLocationsDelayed();
+	void writeLocationsSnapshot();
+	[[nodiscard]] bool writeLocationsJournal(
+		const std::optional<QByteArray> &downloadsWas);
+	[[nodiscard]] Fn<void()> locationsJournalFailedCallback(
+		bool recordsLost);
+	void locationChanged(MediaKey location);
+	void aliasChanged(MediaKey location, MediaKey target);
 
 	std::unique_ptr<Main::SessionSettings> readSessionSettings();
 	void writeSessionSettings(Main::SessionSettings *stored);
@@ -262,6 +282,9 @@ private:
 		FileKey &stickersKey,
 		CheckSet checkSet,
 		const Data::StickersSetsOrder &order);
+	struct PreloadedFile;
+	struct PreloadedStickerSets;
+
 	void readStickerSets(
 		FileKey &stickersKey,
 		Data::StickersSetsOrder *outOrder = nullptr,
@@ -301,6 +324,12 @@ private:
 	QByteArray _downloadsSerialized;
 	Fn<std::optional<QByteArray>()> _downloadsSerialize;
 
+	base::flat_set<MediaKey> _locationsJournalKeys;
+	base::flat_map<MediaKey, MediaKey> _locationsJournalAliases;
+	uint64 _locationsJournalSalt = 0;
+	int64 _locationsJournalSize = 0;
+	int64 _locationsSnapshotSize = 0;
+
 	FileKey _locationsKey = 0;
 	FileKey _trustedPeersKey = 0;
 	FileKey _installedStickersKey = 0;
@@ -333,6 +362,11 @@ private:
 
 	base::flat_map<PeerId, base::flags<PeerTrustFlag>> _trustedPeers;
 	base::flat_map<PeerId, int> _trustedPayPerMessage;
+
+	base::flat_map<
+		FileKey,
+		std::shared_ptr<PreloadedStickerSets>> _preloadedSets;
+	base::flat_map<QString, std::shared_ptr<PreloadedFile>> _preloadedStart;
 	bool _trustedPeersRead = false;
 	bool _readingUserSettings = false;
 	bool _recentHashtagsAndBotsWereRead = false;
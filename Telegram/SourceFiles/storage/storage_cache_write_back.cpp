@@ -0,0 +1,182 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/storage_cache_write_back.h"
+
+namespace Storage {
+namespace {
+
+constexpr auto kInFlightLimit = int64(8 * 1024 * 1024);
+constexpr auto kMemoryLimit = int64(64 * 1024 * 1024);
+constexpr auto kOverloadedAbove = kMemoryLimit / 2;
+constexpr auto kDrainedBelow = kMemoryLimit / 8;
+constexpr auto kLogStatsEach = 100;
+
+} // namespace
+
+CacheWriteBack::CacheWriteBack(not_null<Database*> database)
+: _database(database) {
+}
+
+CacheWriteBack::~CacheWriteBack() {
+	flush();
+}
+
+void CacheWriteBack::put(const Cache::Key &key, TaggedValue &&value) {
+	enqueue(key, std::move(value), false);
+}
+
+void CacheWriteBack::putIfEmpty(
+		const Cache::Key &key,
+		TaggedValue &&value) {
+	enqueue(key, std::move(value), true);
+}
+
+void CacheWriteBack::enqueue(
+		const Cache::Key &key,
+		TaggedValue &&value,
+		bool ifEmpty) {
+	const auto size = int64(value.bytes.size());
+	if (const auto i = _queued.find(key); i != end(_queued)) {
+		// A waiting value is kept by putIfEmpty and replaced by put.
+		++_stats.merged;
+		if (!ifEmpty) {
+			_queuedBytes += size - i->second.value.bytes.size();
+			i->second.value = std::move(value);
+			i->second.ifEmpty = false;
+		}
+		return;
+	} else if (_queuedBytes + _inFlightBytes + size > kMemoryLimit) {
+		++_stats.dropped;
+		DEBUG_LOG(("Cache Warning: Write-back dropped %1 bytes."
+			).arg(size));
+		return;
+	}
+	_queued.emplace(key, Entry{ std::move(value), crl::now(), ifEmpty });
+	_order.push_back(key);
+	_queuedBytes += size;
+	if (_queuedBytes + _inFlightBytes > kOverloadedAbove) {
+		_overloaded = true;
+	}
+	scheduleSend();
+}
+
+void CacheWriteBack::scheduleSend() {
+	if (_sendScheduled) {
+		return;
+	}
+	_sendScheduled = true;
+	crl::on_main(this, [=] {
+		_sendScheduled = false;
+		send();
+	});
+}
+
+void CacheWriteBack::send(bool force) {
+	while (!_order.empty() && (force || _inFlightBytes < kInFlightLimit)) {
+		const auto key = _order.front();
+		_order.pop_front();
+		const auto i = _queued.find(key);
+		Assert(i != end(_queued));
+		auto entry = std::move(i->second);
+		_queued.erase(i);
+		sendEntry(key, std::move(entry));
+	}
+}
+
+void CacheWriteBack::sendEntry(const Cache::Key &key, Entry &&entry) {
+	const auto size = int64(entry.value.bytes.size());
+	_queuedBytes -= size;
+	_inFlightBytes += size;
+	auto done = [=, weak = base::make_weak(this), queued = entry.queued](
+			Cache::Error) {
+		crl::on_main(weak, [=] {
+			sent(size, queued);
+		});
+	};
+	if (entry.ifEmpty) {
+		_database->putIfEmpty(key, std::move(entry.value), std::move(done));
+	} else {
+		_database->put(key, std::move(entry.value), std::move(done));
+	}
+}
+
+void CacheWriteBack::sent(int64 size, crl::time queued) {
+	const auto latency = crl::now() - queued;
+	_inFlightBytes -= size;
+	_stats.lastPutLatency = latency;
+	_stats.maxPutLatency = std::max(_stats.maxPutLatency, latency);
+	if (!(++_stats.written % kLogStatsEach)) {
+		logStats();
+	}
+	send();
+	if (_overloaded && _queuedBytes + _inFlightBytes < kDrainedBelow) {
+		_overloaded = false;
+		_drained.fire({});
+	}
+}
+
+bool CacheWriteBack::overloaded() const {
+	return _overloaded;
+}
+
+rpl::producer<> CacheWriteBack::drained() const {
+	return _drained.events();
+}
+
+auto CacheWriteBack::stats() const -> Stats {
+	auto result = _stats;
+	result.queued = int(_queued.size());
+	result.queuedBytes = _queuedBytes;
+	result.inFlightBytes = _inFlightBytes;
+	return result;
+}
+
+void CacheWriteBack::flush() {
+	send(true);
+}
+
+void CacheWriteBack::flush(const Cache::Key &key) {
+	const auto i = _queued.find(key);
+	if (i == end(_queued)) {
+		return;
+	}
+	auto entry = std::move(i->second);
+	_queued.erase(i);
+	_order.erase(ranges::find(_order, key));
+	sendEntry(key, std::move(entry));
+}
+
+void CacheWriteBack::clear() {
+	_queued.clear();
+	_order.clear();
+	_queuedBytes = 0;
+	if (_overloaded && _inFlightBytes < kDrainedBelow) {
+		_overloaded = false;
+		_drained.fire({});
+	}
+}
+
+void CacheWriteBack::logStats() const {
+	if (!Logs::DebugEnabled()) {
+		return;
+	}
+	const auto now = stats();
+	DEBUG_LOG(("Cache Info: Write-back queued %1 (%2 bytes), "
+		"in flight %3 bytes, put latency %4 ms (max %5 ms), "
+		"written %6, merged %7, dropped %8."
+		).arg(now.queued
+		).arg(now.queuedBytes
+		).arg(now.inFlightBytes
+		).arg(now.lastPutLatency
+		).arg(now.maxPutLatency
+		).arg(now.written
+		).arg(now.merged
+		).arg(now.dropped));
+}
+
+} // namespace Storage
@@ -0,0 +1,80 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "storage/cache/storage_cache_database.h"
+#include "base/weak_ptr.h"
+
+namespace Storage {
+
+// Collects cache puts made on the main thread and passes them to the
+// database with a bounded amount of bytes in flight. Puts of the same
+// key are merged while they wait, the memory for waiting values is capped.
+class CacheWriteBack final : public base::has_weak_ptr {
+public:
+	using Database = Cache::Database;
+	using TaggedValue = Database::TaggedValue;
+
+	struct Stats {
+		int queued = 0;
+		int64 queuedBytes = 0;
+		int64 inFlightBytes = 0;
+		int written = 0;
+		int merged = 0;
+		int dropped = 0;
+		crl::time lastPutLatency = 0;
+		crl::time maxPutLatency = 0;
+	};
+
+	explicit CacheWriteBack(not_null<Database*> database);
+	~CacheWriteBack();
+
+	void put(const Cache::Key &key, TaggedValue &&value);
+	void putIfEmpty(const Cache::Key &key, TaggedValue &&value);
+
+	// Producers that can wait should hold off until drained() fires.
+	[[nodiscard]] bool overloaded() const;
+	[[nodiscard]] rpl::producer<> drained() const;
+	[[nodiscard]] Stats stats() const;
+
+	// Passes all waiting values to the database right away.
+	void flush();
+
+	// Database operations are queued in order, so a get, move or copy
+	// of the key made after this call sees the waiting value.
+	void flush(const Cache::Key &key);
+
+	void clear();
+
+private:
+	struct Entry {
+		TaggedValue value;
+		crl::time queued = 0;
+		bool ifEmpty = false;
+	};
+
+	void enqueue(const Cache::Key &key, TaggedValue &&value, bool ifEmpty);
+	void scheduleSend();
+	void send(bool force = false);
+	void sendEntry(const Cache::Key &key, Entry &&entry);
+	void sent(int64 size, crl::time queued);
+	void logStats() const;
+
+	const not_null<Database*> _database;
+	base::flat_map<Cache::Key, Entry> _queued;
+	std::deque<Cache::Key> _order;
+	int64 _queuedBytes = 0;
+	int64 _inFlightBytes = 0;
+	Stats _stats;
+	bool _sendScheduled = false;
+	bool _overloaded = false;
+	rpl::event_stream<> _drained;
+
+};
+
+} // namespace Storage
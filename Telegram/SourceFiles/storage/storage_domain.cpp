@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "storage/details/storage_file_utilities.h"
 #include "storage/serialize_common.h"
+#include "core/startup_trace.h"
 #include "mtproto/mtproto_config.h"
 #include "main/main_domain.h"
 #include "main/main_account.h"
@@ -39,7 +40,46 @@ Domain::Domain(not_null<Main::Domain*> owner, const QString &dataName)
 Domain::~Domain() = default;
 
 StartResult Domain::start(const QByteArray &passcode) {
-	const auto modern = startModern(passcode);
+	return start(passcode, PreparedKey());
+}
+
+void Domain::startAsync(
+		const QByteArray &passcode,
+		Fn<void(StartResult)> done) {
+	auto salt = readPasscodeKeySalt();
+	if (salt.isEmpty()) {
+		done(start(passcode));
+		return;
+	}
+	crl::async([=, weak = base::make_weak(this)]() mutable {
+		auto key = CreateLocalKey(passcode, salt);
+		crl::on_main(weak, [=, key = std::move(key)]() mutable {
+			done(start(passcode, PreparedKey{
+				.salt = std::move(salt),
+				.key = std::move(key),
+			}));
+		});
+	});
+}
+
+QByteArray Domain::readPasscodeKeySalt() const {
+	FileReadDescriptor keyData;
+	if (!ReadFile(keyData, ComputeKeyName(_dataName), BaseGlobalPath())) {
+		return QByteArray();
+	}
+	auto salt = QByteArray();
+	keyData.stream >> salt;
+	return (CheckStreamStatus(keyData.stream)
+		&& salt.size() == LocalEncryptSaltSize)
+		? salt
+		: QByteArray();
+}
+
+StartResult Domain::start(
+		const QByteArray &passcode,
+		PreparedKey prepared) {
+	const auto trace = Core::StartupTrace::Span("Storage::Domain::start");
+	const auto modern = startModern(passcode, std::move(prepared));
 	if (modern == StartModernResult::Success) {
 		if (_oldVersion < AppVersion) {
 			writeAccounts();
@@ -114,7 +154,8 @@ void Domain::encryptLocalKey(const QByteArray &passcode) {
 }
 
 Domain::StartModernResult Domain::startModern(
-		const QByteArray &passcode) {
+		const QByteArray &passcode,
+		PreparedKey prepared) {
 	const auto name = ComputeKeyName(_dataName);
 
 	FileReadDescriptor keyData;
@@ -133,7 +174,9 @@ Domain::StartModernResult Domain::startModern(
 		LOG(("App Error: bad salt in info file, size: %1").arg(salt.size()));
 		return StartModernResult::Failed;
 	}
-	_passcodeKey = CreateLocalKey(passcode, salt);
+	_passcodeKey = (prepared.key && prepared.salt == salt)
+		? std::move(prepared.key)
+		: CreateLocalKey(passcode, salt);
 
 	EncryptedDescriptor keyInnerData, info;
 	if (!DecryptLocal(keyInnerData, keyEncrypted, _passcodeKey)) {
@@ -168,8 +211,7 @@ Domain::StartModernResult Domain::startModern(
 	_oldVersion = keyData.version;
 
 	auto tried = base::flat_set<int>();
-	auto sessions = base::flat_set<uint64>();
-	auto active = 0;
+	auto accounts = std::vector<Main::Domain::AccountWithIndex>();
 	for (auto i = 0; i != count; ++i) {
 		auto index = qint32();
 		info.stream >> index;
@@ -180,21 +222,34 @@ Domain::StartModernResult Domain::startModern(
 				_owner,
 				_dataName,
 				index);
-			auto config = account->prepareToStart(_localKey);
-			const auto sessionId = account->willHaveSessionUniqueId(
-				config.get());
-			if (!sessions.contains(sessionId)
-				&& (sessionId != 0 || (sessions.empty() && i + 1 == count))) {
-				if (sessions.empty()) {
-					active = index;
-				}
-				account->start(std::move(config));
-				_owner->accountAddedInStorage({
-					.index = index,
-					.account = std::move(account)
-				});
-				sessions.emplace(sessionId);
+
+			// Decrypt the maps of all accounts in parallel.
+			account->local().preloadStart(_localKey);
+			accounts.push_back({
+				.index = index,
+				.account = std::move(account),
+			});
+		}
+	}
+
+	auto sessions = base::flat_set<uint64>();
+	auto active = 0;
+	for (auto &[index, account] : accounts) {
+		const auto last = (&account == &accounts.back().account);
+		auto config = account->prepareToStart(_localKey);
+		const auto sessionId = account->willHaveSessionUniqueId(
+			config.get());
+		if (!sessions.contains(sessionId)
+			&& (sessionId != 0 || (sessions.empty() && last))) {
+			if (sessions.empty()) {
+				active = index;
 			}
+			account->start(std::move(config));
+			_owner->accountAddedInStorage({
+				.index = index,
+				.account = std::move(account)
+			});
+			sessions.emplace(sessionId);
 		}
 	}
 	if (sessions.empty()) {
@@ -250,6 +305,20 @@ bool Domain::checkPasscode(const QByteArray &passcode) const {
 	return checkKey->equals(_passcodeKey);
 }
 
+void Domain::checkPasscodeAsync(
+		const QByteArray &passcode,
+		Fn<void(bool)> done) const {
+	Expects(!_passcodeKeySalt.isEmpty());
+	Expects(_passcodeKey != nullptr);
+
+	crl::async([=, salt = _passcodeKeySalt, key = _passcodeKey] {
+		const auto correct = CreateLocalKey(passcode, salt)->equals(key);
+		crl::on_main([=] {
+			done(correct);
+		});
+	});
+}
+
 void Domain::setPasscode(const QByteArray &passcode) {
 	Expects(!_passcodeKeySalt.isEmpty());
 	Expects(_localKey != nullptr);
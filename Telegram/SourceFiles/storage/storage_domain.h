@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/weak_ptr.h"
+
 namespace MTP {
 class Config;
 class AuthKey;
@@ -26,12 +28,17 @@ enum class StartResult : uchar {
 	IncorrectPasscodeLegacy,
 };
 
-class Domain final {
+class Domain final : public base::has_weak_ptr {
 public:
 	Domain(not_null<Main::Domain*> owner, const QString &dataName);
 	~Domain();
 
 	[[nodiscard]] StartResult start(const QByteArray &passcode);
+
+	// Derives the passcode key on a worker thread.
+	void startAsync(
+		const QByteArray &passcode,
+		Fn<void(StartResult)> done);
 	void startAdded(
 		not_null<Main::Account*> account,
 		std::unique_ptr<MTP::Config> config);
@@ -39,6 +46,9 @@ public:
 	void startFromScratch();
 
 	[[nodiscard]] bool checkPasscode(const QByteArray &passcode) const;
+	void checkPasscodeAsync(
+		const QByteArray &passcode,
+		Fn<void(bool)> done) const;
 	void setPasscode(const QByteArray &passcode);
 
 	[[nodiscard]] int oldVersion() const;
@@ -55,7 +65,18 @@ private:
 		Empty,
 	};
 
-	[[nodiscard]] StartModernResult startModern(const QByteArray &passcode);
+	struct PreparedKey {
+		QByteArray salt;
+		MTP::AuthKeyPtr key;
+	};
+
+	[[nodiscard]] StartResult start(
+		const QByteArray &passcode,
+		PreparedKey prepared);
+	[[nodiscard]] StartModernResult startModern(
+		const QByteArray &passcode,
+		PreparedKey prepared);
+	[[nodiscard]] QByteArray readPasscodeKeySalt() const;
 	void startWithSingleAccount(
 		const QByteArray &passcode,
 		std::unique_ptr<Main::Account> account);
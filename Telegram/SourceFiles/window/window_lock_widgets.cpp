@@ -259,7 +259,9 @@ void PasscodeLockWidget::paintContent(QPainter &p) {
 }
 
 void PasscodeLockWidget::submit() {
-	if (_passcode->text().isEmpty()) {
+	if (_checking) {
+		return;
+	} else if (_passcode->text().isEmpty()) {
 		_passcode->showError();
 		return;
 	}
@@ -270,19 +272,27 @@ void PasscodeLockWidget::submit() {
 		return;
 	}
 
+	// Key derivation is slow, keep the lock screen responsive meanwhile.
 	const auto passcode = _passcode->text().toUtf8();
+	const auto done = crl::guard(this, [=](bool correct) {
+		_checking = false;
+		if (!correct) {
+			cSetPasscodeBadTries(cPasscodeBadTries() + 1);
+			cSetPasscodeLastTry(crl::now());
+			error();
+			return;
+		}
+		Core::App().unlockPasscode(); // Destroys this widget.
+	});
+	_checking = true;
 	auto &domain = Core::App().domain();
-	const auto correct = domain.started()
-		? domain.local().checkPasscode(passcode)
-		: (domain.start(passcode) == Storage::StartResult::Success);
-	if (!correct) {
-		cSetPasscodeBadTries(cPasscodeBadTries() + 1);
-		cSetPasscodeLastTry(crl::now());
-		error();
-		return;
+	if (domain.started()) {
+		domain.local().checkPasscodeAsync(passcode, done);
+	} else {
+		domain.startAsync(passcode, [=](Storage::StartResult result) {
+			done(result == Storage::StartResult::Success);
+		});
 	}
-
-	Core::App().unlockPasscode(); // Destroys this widget.
 }
 
 void PasscodeLockWidget::error() {
@@ -91,6 +91,7 @@ private:
 
 	rpl::lifetime _systemUnlockSuggested;
 	base::Timer _systemUnlockCooldown;
+	bool _checking = false;
 
 };
 
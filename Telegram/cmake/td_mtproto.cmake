@@ -27,10 +27,14 @@ PRIVATE
     mtproto/details/mtproto_dump_to_text.h
     mtproto/details/mtproto_received_ids_manager.cpp
     mtproto/details/mtproto_received_ids_manager.h
+    mtproto/details/mtproto_request_stats.cpp
+    mtproto/details/mtproto_request_stats.h
     mtproto/details/mtproto_rsa_public_key.cpp
     mtproto/details/mtproto_rsa_public_key.h
     mtproto/details/mtproto_serialized_request.cpp
     mtproto/details/mtproto_serialized_request.h
+    mtproto/details/mtproto_session_threads.cpp
+    mtproto/details/mtproto_session_threads.h
     mtproto/details/mtproto_tcp_socket.cpp
     mtproto/details/mtproto_tcp_socket.h
     mtproto/details/mtproto_tls_socket.cpp